@@ -106,6 +106,29 @@ Adafruit_SH1106G::Adafruit_SH1106G(uint16_t w, uint16_t h, SPIClass *spi,
                                    int16_t cs_pin, uint32_t bitrate)
     : Adafruit_SH110X(w, h, spi, dc_pin, rst_pin, cs_pin, bitrate) {}
 
+/*!
+    @brief  Constructor for SH1106G displays driven through a custom bus
+            transport.
+    @param  w
+            Display width in pixels
+    @param  h
+            Display height in pixels
+    @param  transport
+            Pointer to a transport that outlives this object.
+    @param  rst_pin
+            Reset pin (using Arduino pin numbering), or -1 if not used.
+    @warning Never call oled_command(), oled_commandList() or
+            setContrast() through an Adafruit_GrayOLED pointer or
+            reference on this object, see the Adafruit_SH110X transport
+            constructor.
+    @note   Call the object's begin() function before use -- buffer
+            allocation is performed there!
+*/
+Adafruit_SH1106G::Adafruit_SH1106G(uint16_t w, uint16_t h,
+                                   Adafruit_SH110X_Transport *transport,
+                                   int16_t rst_pin)
+    : Adafruit_SH110X(w, h, transport, rst_pin) {}
+
 /*!
     @brief  Destructor for Adafruit_SH1106G object.
 */
@@ -125,53 +148,36 @@ Adafruit_SH1106G::~Adafruit_SH1106G(void) {}
             display. If using multiple SH110X displays on the same bus, and
             if they all share the same reset pin, you should only pass true
             on the first display being initialized, false on all others,
-            else the already-initialized displays would be reset. Default if
-            unspecified is true.
+            else the already-initialized displays would be reset (or use
+            Adafruit_SH110X::beginGroup(), which also overlaps their
+            settle delays). Default if unspecified is true.
+    @param  framebuffer
+            If false, no framebuffer is allocated and there is no splash:
+            for front ends that write display RAM directly, such as
+            Adafruit_SH110X_TextGrid. GFX drawing and display() must not
+            be used then. Default if unspecified is true.
     @return true on successful allocation/init, false otherwise.
             Well-behaved code should check the return value before
             proceeding.
     @note   MUST call this function before any drawing or updates!
 */
-bool Adafruit_SH1106G::begin(uint8_t addr, bool reset) {
-
-  Adafruit_GrayOLED::_init(addr, reset);
-
-  _page_start_offset =
-      2; // the SH1106 display we have found requires a small offset into memory
+bool Adafruit_SH1106G::begin(uint8_t addr, bool reset, bool framebuffer) {
+  return _beginBlocking(addr, reset, framebuffer);
+}
 
+/*!
+    @brief  Chip-specific part of bring-up, run by the begin state machine
+            once the bus is up: splash (if there is a framebuffer), then
+            the panel profile.
+    @return true on success, false if a command could not be sent.
+*/
+bool Adafruit_SH1106G::_configure(void) {
 #ifndef SH110X_NO_SPLASH
-  drawBitmap((WIDTH - splash2_width) / 2, (HEIGHT - splash2_height) / 2,
-             splash2_data, splash2_width, splash2_height, 1);
-#endif
-
-  // Init sequence, make sure its under 32 bytes, or split into multiples!
-  // clang-format off
-  static const uint8_t init[] = {
-      SH110X_DISPLAYOFF,               // 0xAE
-      SH110X_SETDISPLAYCLOCKDIV, 0x80, // 0xD5, 0x80,
-      SH110X_SETMULTIPLEX, 0x3F,       // 0xA8, 0x3F,
-      SH110X_SETDISPLAYOFFSET, 0x00,   // 0xD3, 0x00,
-      SH110X_SETSTARTLINE,             // 0x40
-      SH110X_DCDC, 0x8B,               // DC/DC on
-      SH110X_SEGREMAP + 1,             // 0xA1
-      SH110X_COMSCANDEC,               // 0xC8
-      SH110X_SETCOMPINS, 0x12,         // 0xDA, 0x12,
-      SH110X_SETCONTRAST, 0xFF,        // 0x81, 0xFF
-      SH110X_SETPRECHARGE, 0x1F,       // 0xD9, 0x1F,
-      SH110X_SETVCOMDETECT, 0x40,      // 0xDB, 0x40,
-      0x33,                            // Set VPP to 9V
-      SH110X_NORMALDISPLAY,
-      SH110X_MEMORYMODE, 0x10,         // 0x20, 0x00
-      SH110X_DISPLAYALLON_RESUME,
-  };
-  // clang-format on
-
-  if (!oled_commandList(init, sizeof(init))) {
-    return false;
+  if (buffer) {
+    drawBitmap((WIDTH - splash2_width) / 2, (HEIGHT - splash2_height) / 2,
+               splash2_data, splash2_width, splash2_height, 1);
   }
+#endif
 
-  delay(100);                     // 100ms delay recommended
-  oled_command(SH110X_DISPLAYON); // 0xaf
-
-  return true; // Success
+  return _applyProfile(SH1106_PROFILES);
 }
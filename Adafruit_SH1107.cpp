@@ -106,6 +106,29 @@ Adafruit_SH1107::Adafruit_SH1107(uint16_t w, uint16_t h, SPIClass *spi,
                                  int16_t cs_pin, uint32_t bitrate)
     : Adafruit_SH110X(w, h, spi, dc_pin, rst_pin, cs_pin, bitrate) {}
 
+/*!
+    @brief  Constructor for SH1107 displays driven through a custom bus
+            transport.
+    @param  w
+            Display width in pixels
+    @param  h
+            Display height in pixels
+    @param  transport
+            Pointer to a transport that outlives this object.
+    @param  rst_pin
+            Reset pin (using Arduino pin numbering), or -1 if not used.
+    @warning Never call oled_command(), oled_commandList() or
+            setContrast() through an Adafruit_GrayOLED pointer or
+            reference on this object, see the Adafruit_SH110X transport
+            constructor.
+    @note   Call the object's begin() function before use -- buffer
+            allocation is performed there!
+*/
+Adafruit_SH1107::Adafruit_SH1107(uint16_t w, uint16_t h,
+                                 Adafruit_SH110X_Transport *transport,
+                                 int16_t rst_pin)
+    : Adafruit_SH110X(w, h, transport, rst_pin) {}
+
 /*!
     @brief  Destructor for Adafruit_SH1107 object.
 */
@@ -125,71 +148,48 @@ Adafruit_SH1107::~Adafruit_SH1107(void) {}
             display. If using multiple SH110X displays on the same bus, and
             if they all share the same reset pin, you should only pass true
             on the first display being initialized, false on all others,
-            else the already-initialized displays would be reset. Default if
-            unspecified is true.
+            else the already-initialized displays would be reset (or use
+            Adafruit_SH110X::beginGroup(), which also overlaps their
+            settle delays). Default if unspecified is true.
+    @param  framebuffer
+            If false, no framebuffer is allocated and there is no splash:
+            for front ends that write display RAM directly, such as
+            Adafruit_SH110X_TextGrid. GFX drawing and display() must not
+            be used then. Default if unspecified is true.
     @return true on successful allocation/init, false otherwise.
             Well-behaved code should check the return value before
             proceeding.
     @note   MUST call this function before any drawing or updates!
 */
-bool Adafruit_SH1107::begin(uint8_t addr, bool reset) {
-
-  Adafruit_GrayOLED::_init(addr, reset);
+bool Adafruit_SH1107::begin(uint8_t addr, bool reset, bool framebuffer) {
+  return _beginBlocking(addr, reset, framebuffer);
+}
 
+/*!
+    @brief  Chip-specific part of bring-up, run by the begin state machine
+            once the bus is up: splash (if there is a framebuffer), then
+            the panel profile.
+    @return true on success, false if a command could not be sent.
+*/
+bool Adafruit_SH1107::_configure(void) {
+  _com_lines = 128;
   setContrast(0x2F);
 
 #ifndef SH110X_NO_SPLASH
   // the featherwing with 128x64 oled is 'rotated' so to make the splash right,
-  // rotate!
-  if (WIDTH == 64 && HEIGHT == 128) {
+  // rotate! (and put the caller's rotation back afterwards)
+  if (buffer && (WIDTH == 64) && (HEIGHT == 128)) {
+    uint8_t saved = getRotation();
     setRotation(1);
     drawBitmap((HEIGHT - splash2_width) / 2, (WIDTH - splash2_height) / 2,
                splash2_data, splash2_width, splash2_height, 1);
-    setRotation(0);
+    setRotation(saved);
   }
-  if (WIDTH == 128 && HEIGHT == 128) {
+  if (buffer && (WIDTH == 128) && (HEIGHT == 128)) {
     drawBitmap((HEIGHT - splash2_width) / 2, (WIDTH - splash2_height) / 2,
                splash2_data, splash2_width, splash2_height, 1);
   }
 #endif
 
-  // Init sequence, make sure its under 32 bytes, or split into multiples!
-  // clang-format off
-  static const uint8_t init[] = {
-      SH110X_DISPLAYOFF,               // 0xAE
-      SH110X_SETDISPLAYCLOCKDIV, 0x51, // 0xd5, 0x51,
-      SH110X_MEMORYMODE,               // 0x20
-      SH110X_SETCONTRAST, 0x4F,        // 0x81, 0x4F
-      SH110X_DCDC, 0x8A,               // 0xAD, 0x8A
-      SH110X_SEGREMAP,                 // 0xA0
-      SH110X_COMSCANINC,               // 0xC0
-      SH110X_SETDISPSTARTLINE, 0x0,    // 0xDC 0x00
-      SH110X_SETDISPLAYOFFSET, 0x60,   // 0xd3, 0x60,
-      SH110X_SETPRECHARGE, 0x22,       // 0xd9, 0x22,
-      SH110X_SETVCOMDETECT, 0x35,      // 0xdb, 0x35,
-      SH110X_SETMULTIPLEX, 0x3F,       // 0xa8, 0x3f,
-      // SH110X_SETPAGEADDR,                  // 0xb0
-      // SH110X_SETCOMPINS, 0x12,             // 0xda, 0x12,
-      SH110X_DISPLAYALLON_RESUME, // 0xa4
-      SH110X_NORMALDISPLAY,       // 0xa6
-  };
-  // clang-format on
-
-  if (!oled_commandList(init, sizeof(init))) {
-    return false;
-  }
-
-  if (WIDTH == 128 && HEIGHT == 128) {
-    static const uint8_t init_128x128[] = {
-        SH110X_SETDISPLAYOFFSET, 0x00, SH110X_SETMULTIPLEX, 0x7F, // 0xa8, 0x3f,
-    };
-    if (!oled_commandList(init_128x128, sizeof(init_128x128))) {
-      return false;
-    }
-  }
-
-  delay(100);                     // 100ms delay recommended
-  oled_command(SH110X_DISPLAYON); // 0xaf
-
-  return true; // Success
+  return _applyProfile(SH1107_PROFILES);
 }
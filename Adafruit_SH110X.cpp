@@ -39,6 +39,49 @@
 #include "Adafruit_SH110X.h"
 #include "splash.h"
 
+#ifdef SH110X_ENABLE_STATS
+#define SH110X_STAT(x) x ///< Statistics bookkeeping, compiled in
+#else
+#define SH110X_STAT(x) ///< Statistics bookkeeping, compiled out
+#endif
+
+/*!
+    @brief  Pixel shift and burn-in state, allocated by the first
+            setPixelShift() or setBurnInProtection() that needs it.
+*/
+struct Adafruit_SH110X::ShiftState {
+  int8_t lines;      ///< Image shift set with setPixelShift()
+  int8_t step;       ///< Direction of the next burn-in step
+  uint8_t range;     ///< Burn-in shift limit, 0 = off
+  bool hidden_clear; ///< RAM lines outside the panel blanked
+  uint32_t interval; ///< ms between burn-in steps
+  uint32_t t0;       ///< millis() of the last burn-in step
+};
+
+/*!
+    @brief  Partial display state, allocated by setPartialDisplay() and
+            freed by exitPartialDisplay().
+*/
+struct Adafruit_SH110X::PartialState {
+  uint8_t first;   ///< First line scanned
+  uint8_t count;   ///< Lines scanned
+  int16_t held_x1; ///< Dirty area held back for the full panel
+  int16_t held_y1; ///< Dirty area held back for the full panel
+  int16_t held_x2; ///< Dirty area held back for the full panel
+  int16_t held_y2; ///< Dirty area held back for the full panel
+};
+
+/*!
+    @brief  Frame pacing state, allocated by the first setPacing() or
+            displayPaced().
+*/
+struct Adafruit_SH110X::PacingState {
+  uint32_t interval;     ///< Frame slot length in us, 0 = unpaced
+  uint32_t next;         ///< micros() when the next slot starts
+  bool waiting;          ///< Changes held back since an earlier slot
+  sh110x_pacing_t stats; ///< Frame pacing counters
+};
+
 // CONSTRUCTORS, DESTRUCTOR ------------------------------------------------
 
 /*!
@@ -76,7 +119,8 @@
 Adafruit_SH110X::Adafruit_SH110X(uint16_t w, uint16_t h, TwoWire *twi,
                                  int16_t rst_pin, uint32_t clkDuring,
                                  uint32_t clkAfter)
-    : Adafruit_GrayOLED(1, w, h, twi, rst_pin, clkDuring, clkAfter) {}
+    : Adafruit_GrayOLED(1, w, h, twi, rst_pin, clkDuring, clkAfter),
+      _twi(twi) {}
 
 /*!
     @brief  Constructor for SPI SH110X displays, using software (bitbang)
@@ -139,10 +183,1000 @@ Adafruit_SH110X::Adafruit_SH110X(uint16_t w, uint16_t h, SPIClass *spi,
                                  int16_t cs_pin, uint32_t bitrate)
     : Adafruit_GrayOLED(1, w, h, spi, dc_pin, rst_pin, cs_pin, bitrate) {}
 
+/*!
+    @brief  Constructor for SH110X displays driven through a custom bus
+            transport (DMA engines, parallel buses, test doubles...).
+    @param  w
+            Display width in pixels
+    @param  h
+            Display height in pixels
+    @param  transport
+            Pointer to a transport that outlives this object. Its begin()
+            is called from the display's begin().
+    @param  rst_pin
+            Reset pin (using Arduino pin numbering), or -1 if not used.
+    @warning There is no I2C or SPI device behind Adafruit_GrayOLED with
+            a custom transport. Call oled_command(), oled_commandList()
+            and setContrast() on this class (or a subclass), never
+            through an Adafruit_GrayOLED pointer or reference: the
+            GrayOLED versions would dereference a NULL bus device.
+    @note   Call the object's begin() function before use -- buffer
+            allocation is performed there!
+*/
+Adafruit_SH110X::Adafruit_SH110X(uint16_t w, uint16_t h,
+                                 Adafruit_SH110X_Transport *transport,
+                                 int16_t rst_pin)
+    : Adafruit_GrayOLED(1, w, h, (TwoWire *)NULL, rst_pin),
+      _transport(transport) {}
+
 /*!
     @brief  Destructor for Adafruit_SH110X object.
 */
-Adafruit_SH110X::~Adafruit_SH110X(void) {}
+Adafruit_SH110X::~Adafruit_SH110X(void) {
+  if (_bus_transport) {
+    delete _bus_transport;
+    _bus_transport = NULL;
+  }
+  free(_shift);
+  free(_partial);
+  free(_pacing);
+}
+
+/*!
+    @brief  Common bring-up work: allocate the framebuffer (unless
+            beginAsync() was told not to) and set up the bus transport.
+            The reset pulse is done by pollBegin().
+    @param  addr
+            I2C address (ignored for SPI and custom transports).
+    @return true on success, false otherwise.
+*/
+bool Adafruit_SH110X::_init(uint8_t addr) {
+  bool custom = _transport && (_transport != _bus_transport);
+  if (!_begin_framebuffer) {
+    // no framebuffer: GrayOLED's _init would allocate one, so bring the
+    // bus device up here instead
+    releaseBuffer();
+    if (custom) {
+      return _transport->begin();
+    }
+    if (_twi) {
+      delete i2c_dev;
+      i2c_dev = new Adafruit_I2CDevice(addr, _twi);
+      if (!i2c_dev->begin()) {
+        return false;
+      }
+    } else {
+      if (!spi_dev || !spi_dev->begin()) {
+        return false;
+      }
+      pinMode(dcPin, OUTPUT);
+    }
+  } else if (custom) {
+    // custom transport: there is no I2C/SPI device, so the base class
+    // gives up once it has allocated the framebuffer, before clearing it
+    // (the contrast comes from the panel profile)
+    Adafruit_GrayOLED::_init(addr, false);
+    if (!buffer || !_transport->begin()) {
+      return false;
+    }
+    clearDisplay();
+    return true;
+  } else if (!Adafruit_GrayOLED::_init(addr, false)) {
+    return false;
+  }
+
+  delete _bus_transport;
+  if (i2c_dev) {
+    _bus_transport =
+        new Adafruit_SH110X_I2CTransport(i2c_dev, i2c_preclk, i2c_postclk);
+  } else {
+    _bus_transport = new Adafruit_SH110X_SPITransport(spi_dev, dcPin);
+  }
+  _transport = _bus_transport;
+  return _transport && _transport->begin();
+}
+
+/*!
+    @brief  Start bringing the display up without blocking. Call
+            pollBegin() from loop() (or between other peripherals' setup)
+            until it returns SH110X_BEGIN_READY or SH110X_BEGIN_FAILED.
+    @param  addr
+            I2C address of the display, ignored for SPI.
+    @param  reset
+            If true and a reset pin was given, hard-reset the display
+            first. See begin() about displays sharing a reset pin.
+    @param  framebuffer
+            If false, bring the display up without allocating a
+            framebuffer, see begin().
+    @note   Do not draw before SH110X_BEGIN_READY; the framebuffer is
+            allocated in the INIT step.
+*/
+void Adafruit_SH110X::beginAsync(uint8_t addr, bool reset, bool framebuffer) {
+  _begin_addr = addr;
+  _begin_framebuffer = framebuffer;
+  _begin_step = 0;
+  _begin_t0 = millis();
+  _begin_state =
+      (reset && (rstPin >= 0)) ? SH110X_BEGIN_RESET : SH110X_BEGIN_INIT;
+}
+
+/*!
+    @brief  Advance the bring-up started by beginAsync(). Each call does at
+            most one step and returns straight away if the current wait
+            (10 ms reset phases, 100 ms settle) has not elapsed.
+    @return Current state.
+*/
+sh110x_begin_state_t Adafruit_SH110X::pollBegin(void) {
+  uint32_t now = millis();
+
+  switch (_begin_state) {
+  case SH110X_BEGIN_RESET:
+    if (_begin_step && (now - _begin_t0 < 10)) {
+      break;
+    }
+    if (_begin_step == 0) {
+      pinMode(rstPin, OUTPUT);
+      digitalWrite(rstPin, HIGH); // VDD goes high at start, pause
+    } else if (_begin_step == 1) {
+      digitalWrite(rstPin, LOW); // Bring reset low
+    } else if (_begin_step == 2) {
+      digitalWrite(rstPin, HIGH); // Bring out of reset
+    } else {
+      _begin_state = SH110X_BEGIN_INIT;
+      break;
+    }
+    _begin_step++;
+    _begin_t0 = now;
+    break;
+
+  case SH110X_BEGIN_INIT: {
+    // the controller forgets everything on reset, and the init sequence
+    // must go out now even if register writes are being deferred
+    bool defer = _defer_commands;
+    _defer_commands = false;
+    _regs_known = _regs_pending = 0;
+    _dimmed = _sleeping = false;
+    if (_shift) {
+      _shift->lines = 0;
+      _shift->hidden_clear = false;
+    }
+    free(_partial);
+    _partial = NULL;
+    bool ok = _init(_begin_addr) && _configure();
+    _defer_commands = defer;
+    if (!ok) {
+      _begin_state = SH110X_BEGIN_FAILED;
+      break;
+    }
+    _begin_state = SH110X_BEGIN_SETTLE;
+    _begin_t0 = now;
+    break;
+  }
+
+  case SH110X_BEGIN_SETTLE:
+    if (now - _begin_t0 < 100) { // 100ms delay recommended
+      break;
+    }
+    // sent now even if other register writes are deferred
+    if (!_setRegister(SH110X_REG_POWER, 1) || !_flushRegisters()) {
+      _begin_state = SH110X_BEGIN_FAILED;
+      break;
+    }
+    _begin_state = SH110X_BEGIN_READY;
+    break;
+
+  default:
+    break;
+  }
+  return _begin_state;
+}
+
+/*!
+    @brief  Bring up several displays together: each distinct reset pin is
+            pulsed once, the init sequences are sent back to back, and all
+            panels share one settle period instead of waiting 100 ms each.
+    @param  displays
+            Array of display objects, which may mix SH1106G and SH1107.
+    @param  addrs
+            Their I2C addresses (ignored for SPI), or NULL for 0x3C each.
+    @param  count
+            Number of displays.
+    @param  reset
+            If true, hard-reset the displays that have a reset pin.
+            Displays sharing a reset pin are reset only once.
+    @return true if every display came up; otherwise pollBegin() on each
+            one tells which failed.
+*/
+bool Adafruit_SH110X::beginGroup(Adafruit_SH110X *const *displays,
+                                 const uint8_t *addrs, uint8_t count,
+                                 bool reset) {
+  for (uint8_t i = 0; i < count; i++) {
+    bool first_on_pin = true;
+    for (uint8_t j = 0; j < i; j++) {
+      if (displays[j]->rstPin == displays[i]->rstPin) {
+        first_on_pin = false;
+      }
+    }
+    displays[i]->beginAsync(addrs ? addrs[i] : 0x3C, reset && first_on_pin);
+  }
+
+  // a display sharing a reset pin must not be initialized until the
+  // pulse is over, so finish every reset before anything else moves
+  bool busy;
+  do {
+    busy = false;
+    for (uint8_t i = 0; i < count; i++) {
+      if (displays[i]->_begin_state == SH110X_BEGIN_RESET) {
+        busy = (displays[i]->pollBegin() == SH110X_BEGIN_RESET) || busy;
+      }
+    }
+    if (busy) {
+      delay(1);
+    }
+  } while (busy);
+
+  bool ok;
+  do {
+    busy = false;
+    ok = true;
+    for (uint8_t i = 0; i < count; i++) {
+      sh110x_begin_state_t state = displays[i]->pollBegin();
+      busy = busy || ((state != SH110X_BEGIN_READY) &&
+                      (state != SH110X_BEGIN_FAILED));
+      ok = ok && (state == SH110X_BEGIN_READY);
+    }
+    if (busy) {
+      delay(1);
+    }
+  } while (busy);
+  return ok;
+}
+
+/*!
+    @brief  Run the bring-up state machine to completion, for begin().
+    @param  addr
+            I2C address of the display, ignored for SPI.
+    @param  reset
+            If true and a reset pin was given, hard-reset the display.
+    @param  framebuffer
+            If false, no framebuffer is allocated.
+    @return true once the display is on, false on failure.
+*/
+bool Adafruit_SH110X::_beginBlocking(uint8_t addr, bool reset,
+                                     bool framebuffer) {
+  beginAsync(addr, reset, framebuffer);
+  for (;;) {
+    sh110x_begin_state_t state = pollBegin();
+    if (state == SH110X_BEGIN_READY) {
+      return true;
+    }
+    if (state == SH110X_BEGIN_FAILED) {
+      return false;
+    }
+    delay(1);
+  }
+}
+
+/*!
+    @brief  Route all further bus traffic through another transport, e.g.
+            a recording tap wrapped around getTransport().
+    @param  transport
+            Pointer to the new transport, which must outlive its use here.
+*/
+void Adafruit_SH110X::setTransport(Adafruit_SH110X_Transport *transport) {
+  _transport = transport;
+}
+
+/*!
+    @brief  Choose the panel module profile used by begin(), for modules
+            whose offsets or settings differ from the chip's usual ones.
+    @param  profile
+            Pointer to a profile for this display's size, e.g.
+            &SH1106_PROFILE_128X64_SEG0, or NULL to pick one by size.
+    @note   Call before begin().
+*/
+void Adafruit_SH110X::setProfile(const sh110x_profile_t *profile) {
+  _profile = profile;
+}
+
+/*!
+    @brief  Apply the profile set with setProfile(), or the first of the
+            chip's defaults matching the display size: set the RAM offset
+            and send the init sequence.
+    @param  defaults
+            NULL-terminated profile list, the first entry is the fallback.
+    @return true on success, false if the chosen profile is for another
+            size or a command could not be sent.
+*/
+bool Adafruit_SH110X::_applyProfile(const sh110x_profile_t *const *defaults) {
+  const sh110x_profile_t *profile = _profile;
+  if (!profile) {
+    profile = defaults[0];
+    for (uint8_t i = 0; defaults[i]; i++) {
+      if ((defaults[i]->width == WIDTH) && (defaults[i]->height == HEIGHT)) {
+        profile = defaults[i];
+        break;
+      }
+    }
+  } else if ((profile->width != WIDTH) || (profile->height != HEIGHT)) {
+    return false;
+  }
+
+  _page_start_offset = profile->columnOffset;
+  if (!oled_commandList(profile->init, profile->initLen)) {
+    return false;
+  }
+  // partial display and the frame period read the full-panel settings
+  // from here, so nothing else needs to hold them
+  _profile = profile;
+  // the sequence leaves the display off, not inverted, at its contrast
+  _contrast = _regs[SH110X_REG_CONTRAST] = profile->contrast;
+  _regs[SH110X_REG_INVERT] = _regs[SH110X_REG_POWER] = 0;
+  _regs[SH110X_REG_OFFSET] = profile->offset;
+  _regs[SH110X_REG_MULTIPLEX] = profile->multiplex;
+  _regs[SH110X_REG_CLOCK] = profile->clockDiv;
+  _regs_known = (1 << SH110X_REG_CONTRAST) | (1 << SH110X_REG_INVERT) |
+                (1 << SH110X_REG_POWER) | (1 << SH110X_REG_OFFSET) |
+                (1 << SH110X_REG_MULTIPLEX) | (1 << SH110X_REG_CLOCK);
+  return true;
+}
+
+// LOW-LEVEL COMMANDS ------------------------------------------------------
+
+/*!
+    @brief  Issue a single command byte through the transport. The
+            register shadow is dropped, so later setters resend.
+    @param  c
+            The command byte.
+    @note   Like the other command functions here, this hides a
+            non-virtual Adafruit_GrayOLED member: call it on the
+            Adafruit_SH110X (or subclass) type, see the class notes.
+*/
+void Adafruit_SH110X::oled_command(uint8_t c) {
+  _regs_known = 0; // it may have changed any shadowed register
+  if (_transport) {
+    _sendCommands(&c, 1);
+  }
+}
+
+/*!
+    @brief  Issue a list of commands through the transport. The register
+            shadow is dropped, so later setters resend.
+    @param  c
+            Pointer to the command bytes.
+    @param  n
+            Number of bytes.
+    @return true on success, false on a bus error or before begin().
+*/
+bool Adafruit_SH110X::oled_commandList(const uint8_t *c, uint8_t n) {
+  _regs_known = 0;
+  return _transport && _sendCommands(c, n);
+}
+
+/*!
+    @brief  Adjust the display contrast. Nothing is sent if the contrast
+            is already at this level; while dim() is on, the level is only
+            remembered for when it is switched off.
+    @param  contrastlevel
+            Contrast level, 0 (dimmest) to 255 (brightest).
+*/
+void Adafruit_SH110X::setContrast(uint8_t contrastlevel) {
+  _contrast = contrastlevel;
+  if (!_dimmed) {
+    _setRegister(SH110X_REG_CONTRAST, contrastlevel);
+  }
+}
+
+/*!
+    @brief  Dim the display by lowering its contrast, or restore the level
+            last set with setContrast().
+    @param  dim
+            true to dim, false to restore.
+    @param  level
+            Contrast to use while dimmed. Default if unspecified is 0; the
+            panel is still readable at 0 on most modules.
+*/
+void Adafruit_SH110X::dim(bool dim, uint8_t level) {
+  _dimmed = dim;
+  _setRegister(SH110X_REG_CONTRAST, dim ? level : _contrast);
+}
+
+/*!
+    @brief  Blank the display to save power. The controller keeps its
+            display RAM while off, so nothing needs redrawing on wake().
+            Drawing and display() keep working while asleep.
+*/
+void Adafruit_SH110X::sleep(void) {
+  _sleeping = true;
+  _setRegister(SH110X_REG_POWER, 0);
+  _flushRegisters();
+}
+
+/*!
+    @brief  Switch the display back on after sleep(). If the framebuffer
+            changed while asleep, only the changed area is pushed first,
+            so the old image is never shown; otherwise waking costs a
+            single command byte.
+    @return true on success, false on a bus error or before begin().
+*/
+bool Adafruit_SH110X::wake(void) {
+  if (_sleeping && (window_x1 <= window_x2)) {
+    display();
+  }
+  _setRegister(SH110X_REG_POWER, 1);
+  bool ok = _flushRegisters() && (_regs_known & (1 << SH110X_REG_POWER));
+  if (ok) {
+    _sleeping = false;
+  }
+  return ok;
+}
+
+/*!
+    @brief  Enable or disable display invert mode (white-on-black vs
+            black-on-white). Immediate, does not change the framebuffer.
+            Nothing is sent if the mode is already set.
+    @param  i
+            If true, switch to invert mode (black-on-white), else normal
+            mode (white-on-black).
+*/
+void Adafruit_SH110X::invertDisplay(bool i) {
+  _setRegister(SH110X_REG_INVERT, i);
+}
+
+/*!
+    @brief  Hold register changes (contrast, invert, ...) until the next
+            display() and send them together at the start of its bus
+            session, for UI code that sets them every frame.
+    @param  defer
+            true to hold, false to send straight away again; anything still
+            held is sent now.
+*/
+void Adafruit_SH110X::deferCommands(bool defer) {
+  _defer_commands = defer;
+  if (!defer) {
+    _flushRegisters();
+  }
+}
+
+/*!
+    @brief  Write a shadowed register, skipping the bus if the controller
+            already holds the value.
+    @param  reg
+            Register to write.
+    @param  value
+            New value.
+    @return true if nothing needed sending or it was sent (or deferred),
+            false on a bus error or before begin().
+*/
+bool Adafruit_SH110X::_setRegister(sh110x_reg_t reg, uint8_t value) {
+  uint8_t bit = 1 << reg;
+  if ((_regs_known & bit) && (_regs[reg] == value)) {
+    _regs_pending &= ~bit; // a deferred change was undone
+    return true;
+  }
+  _regs_next[reg] = value;
+  _regs_pending |= bit;
+  return _defer_commands || _flushRegisters();
+}
+
+/*!
+    @brief  Send every pending register write as one command transaction.
+    @return true on success or if nothing was pending, false on a bus error
+            or before begin().
+*/
+bool Adafruit_SH110X::_flushRegisters(void) {
+  uint8_t cmd[SH110X_REG_COUNT * 2];
+  uint8_t n = 0;
+  for (uint8_t reg = 0; reg < SH110X_REG_COUNT; reg++) {
+    if (!(_regs_pending & (1 << reg))) {
+      continue;
+    }
+    uint8_t value = _regs_next[reg];
+    switch (reg) {
+    case SH110X_REG_CONTRAST:
+      cmd[n++] = SH110X_SETCONTRAST;
+      cmd[n++] = value;
+      break;
+    case SH110X_REG_INVERT:
+      cmd[n++] = value ? SH110X_INVERTDISPLAY : SH110X_NORMALDISPLAY;
+      break;
+    case SH110X_REG_POWER:
+      cmd[n++] = value ? SH110X_DISPLAYON : SH110X_DISPLAYOFF;
+      break;
+    case SH110X_REG_OFFSET:
+      cmd[n++] = SH110X_SETDISPLAYOFFSET;
+      cmd[n++] = value;
+      break;
+    case SH110X_REG_MULTIPLEX:
+      cmd[n++] = SH110X_SETMULTIPLEX;
+      cmd[n++] = value;
+      break;
+    case SH110X_REG_CLOCK:
+      cmd[n++] = SH110X_SETDISPLAYCLOCKDIV;
+      cmd[n++] = value;
+      break;
+    case SH110X_REG_START_LINE:
+      if (_com_lines == 128) {
+        cmd[n++] = SH110X_SETDISPSTARTLINE;
+        cmd[n++] = value;
+      } else {
+        cmd[n++] = SH110X_SETSTARTLINE | value;
+      }
+      break;
+    }
+    _regs[reg] = value;
+  }
+  if (!n) {
+    return true;
+  }
+  if (!_transport || !_sendCommands(cmd, n)) {
+    // the controller state is unknown now, resend next time
+    _regs_known &= ~_regs_pending;
+    _regs_pending = 0;
+    return false;
+  }
+  _regs_known |= _regs_pending;
+  _regs_pending = 0;
+  return true;
+}
+
+// BURN-IN PROTECTION ------------------------------------------------------
+
+/*!
+    @brief  Move the whole image along the COM lines (vertically on SH1106,
+            along x on SH1107) using the start line register, without
+            redrawing. Drawing coordinates do not change. Lines pushed past
+            one edge are blanked rather than wrapping round to the other,
+            so only those thin edge strips are sent.
+    @param  lines
+            Shift in lines, less than half the panel size either way;
+            positive moves the image towards line 0. 0 restores it.
+    @return true on success, false if out of range, on a bus error or
+            before begin().
+    @note   writeDisplayData() writes are not adjusted for the shift.
+            Not available in partial display mode.
+*/
+bool Adafruit_SH110X::setPixelShift(int8_t lines) {
+  bool com_x = (_com_lines == 128);
+  uint8_t n = com_x ? WIDTH : HEIGHT; // lines along the COMs
+  if (!buffer || !_transport || _partial || (abs(lines) >= n / 2)) {
+    return false;
+  }
+  if (!_shift) {
+    if (!lines) {
+      return true; // never shifted, nothing to restore
+    }
+    if (!_allocShift()) {
+      return false;
+    }
+  }
+
+  uint8_t edge = max(abs(_shift->lines), abs(lines));
+  uint8_t pages = (HEIGHT + 7) / 8;
+  bool ok = true;
+  _shift->lines = lines;
+
+  beginSession();
+  for (uint8_t p = 0; p < pages; p++) {
+    if (com_x) {
+      ok = _writeShifted(p, 0, edge) && ok;
+      ok = _writeShifted(p, n - edge, edge) && ok;
+    } else if ((p * 8 < edge) || (p * 8 + 7 >= n - edge)) {
+      ok = _writeShifted(p, 0, WIDTH) && ok;
+    }
+  }
+  if ((n < _com_lines) && !_shift->hidden_clear) {
+    // RAM lines past the panel are never drawn; blank them once so they
+    // show nothing when shifted into view
+    if (com_x) {
+      for (uint8_t p = 0; p < pages; p++) {
+        ok = _writeShifted(p, n, _com_lines - n) && ok;
+      }
+    } else {
+      for (uint8_t p = pages; p < _com_lines / 8; p++) {
+        ok = _writeShifted(p, 0, WIDTH) && ok;
+      }
+    }
+    _shift->hidden_clear = ok;
+  }
+  _setRegister(SH110X_REG_START_LINE,
+               (uint8_t)((lines + _com_lines) % _com_lines));
+  ok = _flushRegisters() && ok;
+  endSession();
+  return ok;
+}
+
+/*!
+    @brief  Current hardware image shift, see setPixelShift().
+    @return Shift in lines.
+*/
+int8_t Adafruit_SH110X::getPixelShift(void) const {
+  return _shift ? _shift->lines : 0;
+}
+
+/*!
+    @brief  Slowly move the image back and forth to spread OLED wear, one
+            line every interval, between -range and +range. Call
+            burnInTick() from loop(). Keep content that must stay visible
+            at least range pixels from the two edges the image moves
+            towards.
+    @param  range
+            Largest shift in lines, 0 to stop and restore the image.
+    @param  interval_ms
+            Time between steps. Default if unspecified is one minute.
+*/
+void Adafruit_SH110X::setBurnInProtection(uint8_t range, uint32_t interval_ms) {
+  if (!_shift && (!range || !_allocShift())) {
+    return;
+  }
+  _shift->range = range;
+  _shift->interval = interval_ms;
+  _shift->t0 = millis();
+  if (!range) {
+    setPixelShift(0);
+  }
+}
+
+/*!
+    @brief  Take the next burn-in step if its interval has passed.
+    @return true if the image moved.
+*/
+bool Adafruit_SH110X::burnInTick(void) {
+  if (!_shift || !_shift->range ||
+      (millis() - _shift->t0 < _shift->interval)) {
+    return false;
+  }
+  _shift->t0 = millis();
+  if (abs(_shift->lines + _shift->step) > _shift->range) {
+    _shift->step = -_shift->step;
+  }
+  return setPixelShift(_shift->lines + _shift->step);
+}
+
+/*!
+    @brief  Allocate the pixel shift state on first use.
+    @return true on success, false if out of memory.
+*/
+bool Adafruit_SH110X::_allocShift(void) {
+  if (!(_shift = (ShiftState *)calloc(1, sizeof(ShiftState)))) {
+    return false;
+  }
+  _shift->step = 1;
+  return true;
+}
+
+/*!
+    @brief  Send part of a framebuffer page while an image shift is set,
+            blanking the lines that are shifted out of view, inside a
+            transport session opened by the caller.
+    @param  page
+            Page to write to.
+    @param  column
+            First column, in framebuffer coordinates; columns past the
+            framebuffer (and pages past it) are sent as blank.
+    @param  len
+            Number of columns.
+    @return true on success, false if a bus write failed.
+*/
+bool Adafruit_SH110X::_writeShifted(uint8_t page, uint8_t column,
+                                    uint8_t len) {
+  bool com_x = (_com_lines == 128);
+  int16_t shift = _shift ? _shift->lines : 0;
+  int16_t lo = shift;                                // first line in view
+  int16_t hi = (com_x ? WIDTH : HEIGHT) - 1 + shift; // last line in view
+  bool in_buffer = (page < (HEIGHT + 7) / 8);
+
+  uint8_t mask = 0xFF; // rows of this page still in view (SH1106)
+  if (!com_x) {
+    for (uint8_t b = 0; b < 8; b++) {
+      if ((page * 8 + b < lo) || (page * 8 + b > hi)) {
+        mask &= ~(1 << b);
+      }
+    }
+  }
+  if (in_buffer && (mask == 0xFF) && (column + len <= WIDTH) &&
+      (!com_x || ((column >= lo) && (column + len - 1 <= hi)))) {
+    return _writePage(page, column, buffer + page * WIDTH + column, len);
+  }
+
+  uint8_t tmp[32];
+  bool ok = true;
+  while (ok && len) {
+    uint8_t chunk = min(len, (uint8_t)sizeof(tmp));
+    for (uint8_t j = 0; j < chunk; j++) {
+      uint8_t x = column + j;
+      bool visible =
+          in_buffer && (x < WIDTH) && (!com_x || ((x >= lo) && (x <= hi)));
+      tmp[j] = visible ? (buffer[page * WIDTH + x] & mask) : 0;
+    }
+    ok = _writePage(page, column, tmp, chunk);
+    column += chunk;
+    len -= chunk;
+  }
+  return ok;
+}
+
+// PARTIAL DISPLAY ---------------------------------------------------------
+
+/*!
+    @brief  Scan only a strip of lines along the COMs (rows on SH1106,
+            columns on SH1107), for an idle status strip: the multiplex
+            ratio is cut and the display offset moved so only those lines
+            are driven, which lowers panel current, and display() only
+            sends the strip. The rest of the panel goes dark but keeps its
+            content in display RAM.
+    @param  first
+            First framebuffer line of the strip.
+    @param  count
+            Number of lines, at least 16.
+    @return true on success, false if the strip does not fit, on a bus
+            error or before begin().
+    @note   The strip is shown where the controller drives its first COMs
+            (the middle of the COM range on SH1107, the COM0 end on SH1106),
+            not necessarily where it sits in the full image. Any pixel
+            shift is undone first.
+*/
+bool Adafruit_SH110X::setPartialDisplay(uint8_t first, uint8_t count) {
+  uint8_t n = (_com_lines == 128) ? WIDTH : HEIGHT;
+  if (!buffer || !_profile || (count < 16) ||
+      (count > _profile->multiplex + 1) || (first + count > n)) {
+    return false;
+  }
+  if (getPixelShift() && !setPixelShift(0)) {
+    return false;
+  }
+  if (!_partial) {
+    if (!(_partial = (PartialState *)malloc(sizeof(PartialState)))) {
+      return false;
+    }
+    _partial->held_x1 = _partial->held_y1 = 1024;
+    _partial->held_x2 = _partial->held_y2 = -1;
+  }
+
+  // scan line j must show line first + j; on SH1107 the driven COMs stay
+  // centred, so lines dropped from the start of the scan shift it too
+  uint8_t mux = _profile->multiplex;
+  int16_t drop = (_com_lines == 128) ? (mux + 1 - count) / 2 : 0;
+  int16_t offset = _profile->offset + first - drop;
+  _partial->first = first;
+  _partial->count = count;
+  _setRegister(SH110X_REG_MULTIPLEX, count - 1);
+  _setRegister(SH110X_REG_OFFSET,
+               (uint8_t)((offset + _com_lines) % _com_lines));
+  return _flushRegisters();
+}
+
+/*!
+    @brief  Go back to scanning the whole panel after setPartialDisplay().
+            The retained image comes back as it was; only what was drawn
+            outside the strip in the meantime is sent.
+    @return true on success, false on a bus error or before begin().
+*/
+bool Adafruit_SH110X::exitPartialDisplay(void) {
+  if (!_partial) {
+    return true;
+  }
+  PartialState held = *_partial;
+  free(_partial);
+  _partial = NULL;
+  _setRegister(SH110X_REG_MULTIPLEX, _profile->multiplex);
+  _setRegister(SH110X_REG_OFFSET, _profile->offset);
+  bool ok = _flushRegisters();
+
+  if (held.held_x1 <= held.held_x2) {
+    markDirty(held.held_x1, held.held_y1, held.held_x2, held.held_y2);
+    display();
+  }
+  return ok;
+}
+
+// PANEL TIMING ------------------------------------------------------------
+
+/*!
+    @brief  Set the panel's internal refresh clock, e.g. so it does not
+            beat against the flush rate in animation.
+    @param  frequency
+            Oscillator setting, 0 (about -25%) to 15 (about +50%) in steps
+            of about 5%; 5 is the nominal frequency.
+    @param  divide
+            Clock divide ratio, 1 to 16.
+    @return true on success, false if out of range, on a bus error or
+            before begin().
+*/
+bool Adafruit_SH110X::setDisplayClock(uint8_t frequency, uint8_t divide) {
+  if ((frequency > 15) || !divide || (divide > 16)) {
+    return false;
+  }
+  return _setRegister(SH110X_REG_CLOCK, (frequency << 4) | (divide - 1));
+}
+
+/*!
+    @brief  Pick the clock setting whose frame rate comes closest to a
+            target, at the current multiplex ratio.
+    @param  hz
+            Wanted panel frame rate.
+    @return Resulting frame period in microseconds, see
+            getFramePeriodMicros(), or 0 if the clock could not be set.
+*/
+uint32_t Adafruit_SH110X::setFrameRate(uint16_t hz) {
+  if (!hz) {
+    return 0;
+  }
+  uint32_t target = 1000000UL / hz;
+  uint8_t mux = (_regs_pending & (1 << SH110X_REG_MULTIPLEX))
+                    ? _regs_next[SH110X_REG_MULTIPLEX]
+                    : _regs[SH110X_REG_MULTIPLEX];
+  uint8_t best = 0;
+  uint32_t best_err = 0xFFFFFFFF;
+  for (uint16_t clk = 0; clk < 256; clk++) {
+    uint32_t period = _framePeriod(clk, mux);
+    uint32_t err = (period > target) ? period - target : target - period;
+    if (err < best_err) {
+      best_err = err;
+      best = clk;
+    }
+  }
+  if (!setDisplayClock(best >> 4, (best & 0x0F) + 1)) {
+    return 0;
+  }
+  return getFramePeriodMicros();
+}
+
+/*!
+    @brief  Estimate the time the panel takes to scan one frame, from the
+            clock, precharge and multiplex settings. Lock animation or
+            flush cadence to a multiple of it to avoid shimmer.
+    @return Frame period in microseconds. Typical only: the oscillator of
+            individual parts varies by about 15%.
+*/
+uint32_t Adafruit_SH110X::getFramePeriodMicros(void) const {
+  uint8_t clk = _regs[SH110X_REG_CLOCK];
+  uint8_t mux = _regs[SH110X_REG_MULTIPLEX];
+  if (_regs_pending & (1 << SH110X_REG_CLOCK)) {
+    clk = _regs_next[SH110X_REG_CLOCK];
+  }
+  if (_regs_pending & (1 << SH110X_REG_MULTIPLEX)) {
+    mux = _regs_next[SH110X_REG_MULTIPLEX];
+  }
+  return _framePeriod(clk, mux);
+}
+
+/*!
+    @brief  Frame period for a clock setting and multiplex ratio.
+    @param  clk
+            0xD5 argument.
+    @param  mux
+            0xA8 argument.
+    @return Frame period in microseconds.
+*/
+uint32_t Adafruit_SH110X::_framePeriod(uint8_t clk, uint8_t mux) const {
+  // frame rate = Fosc / (divide * clocks per row * rows)
+  uint8_t precharge = _profile ? _profile->precharge : 0x22; // reset value
+  uint32_t row_clocks = (precharge & 0x0F) + (precharge >> 4) +
+                        SH110X_ROW_CLOCKS;
+  uint32_t clocks = ((clk & 0x0F) + 1) * row_clocks * (mux + 1);
+  uint32_t osc_100hz = SH110X_OSC_HZ / 100 * (75 + 5 * (clk >> 4)) / 100;
+  return clocks * 10000 / osc_100hz;
+}
+
+// FRAME PACING ------------------------------------------------------------
+
+/*!
+    @brief  Set the frame rate for displayPaced().
+    @param  fps
+            Target flushes per second, or 0 to let every displayPaced() call
+            flush straight away.
+    @param  lock_to_panel
+            If true, round the frame interval to a whole number of panel
+            frames (see getFramePeriodMicros()), so flushes do not beat
+            against the panel's own refresh.
+    @return Frame interval in microseconds, 0 if unpaced.
+*/
+uint32_t Adafruit_SH110X::setPacing(uint16_t fps, bool lock_to_panel) {
+  if (!_pacing && (!fps || !_allocPacing())) {
+    return 0;
+  }
+  _pacing->interval = fps ? 1000000UL / fps : 0;
+  if (_pacing->interval && lock_to_panel) {
+    uint32_t period = getFramePeriodMicros();
+    uint32_t frames = (_pacing->interval + period / 2) / period;
+    _pacing->interval = max(frames, (uint32_t)1) * period;
+  }
+  _pacing->next = micros();
+  _pacing->waiting = false;
+  return _pacing->interval;
+}
+
+/*!
+    @brief  Flush at most once per frame interval: call it wherever
+            display() would be called, as often as convenient. Drawing done
+            between calls builds up in the dirty window and goes out as one
+            flush when the next frame slot starts; slots with no changes
+            send nothing.
+    @return true if a flush was sent.
+    @note   Call it from loop() even when nothing is drawn, so held-back
+            changes go out once their slot comes.
+*/
+bool Adafruit_SH110X::displayPaced(void) {
+  bool dirty = (window_x1 <= window_x2);
+  if (!_pacing && !_allocPacing()) { // still flush, just uncounted
+    if (dirty) {
+      display();
+    }
+    return dirty;
+  }
+  sh110x_pacing_t &stats = _pacing->stats;
+  if (!_pacing->interval) {
+    if (dirty) {
+      display();
+      stats.frames++;
+    }
+    return dirty;
+  }
+
+  uint32_t now = micros();
+  if ((int32_t)(now - _pacing->next) < 0) { // slot not started yet
+    if (dirty) {
+      stats.coalesced++;
+      _pacing->waiting = true;
+    }
+    return false;
+  }
+
+  // slots that went by entirely before this call
+  uint32_t interval = _pacing->interval;
+  uint32_t missed = (now - _pacing->next) / interval;
+  uint32_t slot = _pacing->next + missed * interval;
+  _pacing->next = slot + interval;
+  if (!dirty) {
+    stats.skipped += missed + 1;
+    return false;
+  }
+  if (_pacing->waiting) {
+    stats.dropped += missed;
+  } else {
+    stats.skipped += missed;
+  }
+  _pacing->waiting = false;
+
+  display();
+  stats.frames++;
+  uint32_t overrun = (micros() - slot) / interval;
+  if (overrun) {
+    // the bus could not keep up: the slots this flush ran into are lost
+    stats.late++;
+    stats.dropped += overrun;
+    _pacing->next = slot + (overrun + 1) * interval;
+  }
+  return true;
+}
+
+/*!
+    @brief  Frame pacing counters since the last resetPacingStats().
+    @return Reference to the live counters, all zero before the first
+            setPacing() or displayPaced().
+*/
+const sh110x_pacing_t &Adafruit_SH110X::getPacingStats(void) const {
+  static const sh110x_pacing_t none = {};
+  return _pacing ? _pacing->stats : none;
+}
+
+/*!
+    @brief  Zero the frame pacing counters.
+*/
+void Adafruit_SH110X::resetPacingStats(void) {
+  if (_pacing) {
+    memset(&_pacing->stats, 0, sizeof(_pacing->stats));
+  }
+}
+
+/*!
+    @brief  Allocate the frame pacing state on first use, unpaced.
+    @return true on success, false if out of memory.
+*/
+bool Adafruit_SH110X::_allocPacing(void) {
+  return (_pacing = (PacingState *)calloc(1, sizeof(PacingState))) != NULL;
+}
 
 // REFRESH DISPLAY ---------------------------------------------------------
 
@@ -159,11 +1193,43 @@ void Adafruit_SH110X::display(void) {
   // a screen write and one immediately after should cover it.  But if
   // not, if this becomes a problem, yields() might be added in the
   // 32-byte transfer condition below.
+  SH110X_TRACE(SH110X_TRACE_YIELD, 0);
   yield();
 
+  if (!buffer || !_transport) { // released (e.g. text mode) or not begun
+    return;
+  }
+
+  if (_partial) {
+    // only the strip is scanned; keep the whole dirty area for when the
+    // full panel comes back, and send just the part inside the strip
+    if (window_x1 <= window_x2) {
+      _partial->held_x1 = min(_partial->held_x1, window_x1);
+      _partial->held_y1 = min(_partial->held_y1, window_y1);
+      _partial->held_x2 = max(_partial->held_x2, window_x2);
+      _partial->held_y2 = max(_partial->held_y2, window_y2);
+    }
+    int16_t first = _partial->first;
+    int16_t last = first + _partial->count - 1;
+    if (_com_lines == 128) {
+      window_x1 = max(window_x1, first);
+      window_x2 = min(window_x2, last);
+    } else {
+      window_y1 = max(window_y1, first);
+      window_y2 = min(window_y2, last);
+    }
+    if ((window_x1 > window_x2) || (window_y1 > window_y2)) {
+      window_x1 = window_y1 = 1024;
+      window_x2 = window_y2 = -1;
+    }
+  }
+
+  SH110X_TRACE(SH110X_TRACE_FLUSH, 0);
+  SH110X_STAT(uint32_t t0 = micros());
+  SH110X_STAT(_statDirty());
+
   // uint16_t count = WIDTH * ((HEIGHT + 7) / 8);
   uint8_t *ptr = buffer;
-  uint8_t dc_byte = 0x40;
   uint8_t pages = ((HEIGHT + 7) / 8);
 
   uint8_t bytes_per_page = WIDTH;
@@ -181,15 +1247,18 @@ void Adafruit_SH110X::display(void) {
   */
 
   uint8_t first_page = window_y1 / 8;
-  //  uint8_t last_page = (window_y2 + 7) / 8;
+  // only push the pages the dirty window touches, so a small update
+  // (e.g. one text cell) does not resend everything below it
+  if (window_y2 < HEIGHT) {
+    pages = (window_y2 + 8) / 8;
+  }
   uint8_t page_start = min(bytes_per_page, (uint8_t)window_x1);
   uint8_t page_end = (uint8_t)max((int)0, (int)window_x2);
   /*
   Serial.print("Pages: ");
   Serial.print(first_page);
   Serial.print(" -> ");
-  Serial.println(last_page);
-  pages = min(pages, last_page);
+  Serial.println(pages);
 
   Serial.print("Page addr: ");
   Serial.print(page_start);
@@ -197,6 +1266,12 @@ void Adafruit_SH110X::display(void) {
   Serial.println(page_end);
   */
 
+#ifdef SH110X_ENABLE_TRACE
+  _flushing = true;
+#endif
+  beginSession();
+  _flushRegisters(); // deferred contrast etc. ride along with the frame
+
   for (uint8_t p = first_page; p < pages; p++) {
     uint8_t bytes_remaining = bytes_per_page;
     ptr = buffer + (uint16_t)p * (uint16_t)bytes_per_page;
@@ -206,45 +1281,221 @@ void Adafruit_SH110X::display(void) {
     // cut off end of dirty rectangle
     bytes_remaining -= (WIDTH - 1) - page_end;
 
-    if (i2c_dev) { // I2C
-      uint16_t maxbuff = i2c_dev->maxBufferSize() - 1;
-
-      uint8_t cmd[] = {
-          0x00, (uint8_t)(SH110X_SETPAGEADDR + p),
-          (uint8_t)(0x10 + ((page_start + _page_start_offset) >> 4)),
-          (uint8_t)((page_start + _page_start_offset) & 0xF)};
-
-      // Set high speed clk
-      i2c_dev->setSpeed(i2c_preclk);
-
-      i2c_dev->write(cmd, 4);
+    if (_shift && _shift->lines) {
+      _writeShifted(p, page_start, bytes_remaining);
+    } else {
+      _writePage(p, page_start, ptr, bytes_remaining);
+    }
+  }
 
-      while (bytes_remaining) {
-        uint8_t to_write = min(bytes_remaining, (uint8_t)maxbuff);
-        i2c_dev->write(ptr, to_write, true, &dc_byte, 1);
-        ptr += to_write;
-        bytes_remaining -= to_write;
-        yield();
-      }
+  endSession();
+#ifdef SH110X_ENABLE_TRACE
+  _flushing = false;
+#endif
 
-      // Set low speed clk
-      i2c_dev->setSpeed(i2c_postclk);
+  SH110X_STAT(uint32_t t = micros() - t0);
+  SH110X_STAT(_stats.flushMicros += t);
+  SH110X_STAT(_stats.maxFlushMicros = max(_stats.maxFlushMicros, t));
 
-    } else { // SPI
-      uint8_t cmd[] = {
-          (uint8_t)(SH110X_SETPAGEADDR + p),
-          (uint8_t)(0x10 + ((page_start + _page_start_offset) >> 4)),
-          (uint8_t)((page_start + _page_start_offset) & 0xF)};
+  SH110X_TRACE(SH110X_TRACE_FLUSH | SH110X_TRACE_END, 0);
 
-      digitalWrite(dcPin, LOW);
-      spi_dev->write(cmd, 3);
-      digitalWrite(dcPin, HIGH);
-      spi_dev->write(ptr, bytes_remaining);
-    }
-  }
   // reset dirty window
   window_x1 = 1024;
   window_y1 = 1024;
   window_x2 = -1;
   window_y2 = -1;
 }
+
+/*!
+    @brief  Write a run of bytes straight into the display RAM of one page,
+            bypassing the framebuffer and dirty window.
+    @param  page
+            Page (group of 8 rows) to write to.
+    @param  column
+            First column to write, in framebuffer coordinates (any
+            controller-specific column offset is added here).
+    @param  data
+            Column bytes to send, LSB is the top row of the page.
+    @param  len
+            Number of bytes to send. Must not run past the page end.
+    @return true on success, false if a bus write failed.
+*/
+bool Adafruit_SH110X::writeDisplayData(uint8_t page, uint8_t column,
+                                       const uint8_t *data, uint8_t len) {
+  if (!_transport) {
+    return false;
+  }
+  beginSession();
+  bool ok = _writePage(page, column, data, len);
+  endSession();
+  return ok;
+}
+
+/*!
+    @brief  Group the following writes into one transport session, e.g. so
+            a front end that sends many writeDisplayData() runs switches
+            the I2C clock once per frame instead of once per run. Sessions
+            nest: only the outermost pair reaches the transport.
+    @note   Every beginSession() must be matched by an endSession().
+*/
+void Adafruit_SH110X::beginSession(void) {
+  if (_transport && !_sessions++) {
+    _transport->beginSession();
+  }
+}
+
+/*!
+    @brief  End a group of writes started with beginSession().
+*/
+void Adafruit_SH110X::endSession(void) {
+  if (_transport && _sessions && !--_sessions) {
+    _transport->endSession();
+  }
+}
+
+/*!
+    @brief  Address one page/column and stream data into it, inside a
+            transport session opened by the caller.
+    @param  page
+            Page to write to.
+    @param  column
+            First column, in framebuffer coordinates.
+    @param  data
+            Column bytes to send.
+    @param  len
+            Number of bytes to send.
+    @return true on success, false if a bus write failed.
+*/
+bool Adafruit_SH110X::_writePage(uint8_t page, uint8_t column,
+                                 const uint8_t *data, uint8_t len) {
+  uint8_t col = column + _page_start_offset;
+  uint8_t cmd[] = {(uint8_t)(SH110X_SETPAGEADDR + page),
+                   (uint8_t)(0x10 + (col >> 4)), (uint8_t)(col & 0xF)};
+
+  SH110X_STAT(_stats.pages++);
+  SH110X_TRACE(SH110X_TRACE_PAGE, page);
+  bool ok = _sendCommands(cmd, sizeof(cmd));
+  if (ok && len) {
+    ok = _sendData(data, len);
+  }
+  SH110X_TRACE(SH110X_TRACE_PAGE | SH110X_TRACE_END, page);
+  return ok;
+}
+
+/*!
+    @brief  Send command bytes through the transport. Every command write
+            goes through here, so the statistics see all of them.
+    @param  cmds
+            Command bytes.
+    @param  len
+            Number of bytes.
+    @return true on success, false if the bus write failed.
+*/
+bool Adafruit_SH110X::_sendCommands(const uint8_t *cmds, uint8_t len) {
+  bool ok = _transport->writeCommands(cmds, len);
+  SH110X_STAT(_stats.transactions++);
+  SH110X_STAT(if (ok) _stats.commandBytes += len; else _stats.busErrors++);
+  return ok;
+}
+
+/*!
+    @brief  Send display RAM bytes through the transport, the data
+            counterpart of _sendCommands().
+    @param  data
+            Column bytes.
+    @param  len
+            Number of bytes.
+    @return true on success, false if the bus write failed.
+*/
+bool Adafruit_SH110X::_sendData(const uint8_t *data, uint8_t len) {
+  bool ok = _transport->writeData(data, len);
+  SH110X_STAT(_stats.transactions++);
+  SH110X_STAT(if (ok) _stats.dataBytes += len; else _stats.busErrors++);
+  return ok;
+}
+
+/*!
+    @brief  Free the framebuffer allocated by begin(). For text-only or
+            tile-based front ends that render straight into display RAM
+            with writeDisplayData() and want the RAM back.
+    @note   After this, display() does nothing and GFX drawing calls on
+            this object must not be used until begin() is called again.
+*/
+void Adafruit_SH110X::releaseBuffer(void) {
+  if (buffer) {
+    free(buffer);
+    buffer = NULL;
+  }
+}
+
+/*!
+    @brief  Grow the dirty window that display() pushes, for code that
+            writes into getBuffer() directly instead of through drawPixel().
+    @param  x1
+            Left column, in native (unrotated) framebuffer coordinates.
+    @param  y1
+            Top row.
+    @param  x2
+            Right column (inclusive).
+    @param  y2
+            Bottom row (inclusive).
+*/
+void Adafruit_SH110X::markDirty(int16_t x1, int16_t y1, int16_t x2,
+                                int16_t y2) {
+  window_x1 = min(window_x1, max(x1, (int16_t)0));
+  window_y1 = min(window_y1, max(y1, (int16_t)0));
+  window_x2 = max(window_x2, min(x2, (int16_t)(WIDTH - 1)));
+  window_y2 = max(window_y2, min(y2, (int16_t)(HEIGHT - 1)));
+}
+
+#if defined(SH110X_ENABLE_STATS) || defined(SH110X_ENABLE_TRACE)
+
+// STATISTICS AND TRACING --------------------------------------------------
+
+/*!
+    @brief  Set a pixel, counting the call for the flush statistics and
+            tracing calls made while a flush is running (from an ISR or
+            another core).
+    @param  x
+            Column, in rotated coordinates.
+    @param  y
+            Row, in rotated coordinates.
+    @param  color
+            SH110X_WHITE, SH110X_BLACK or SH110X_INVERSE.
+*/
+void Adafruit_SH110X::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  SH110X_STAT(_stats.pendingPixels++);
+#ifdef SH110X_ENABLE_TRACE
+  if (_flushing) {
+    SH110X_TRACE(SH110X_TRACE_OVERLAP, 0);
+  }
+#endif
+  Adafruit_GrayOLED::drawPixel(x, y, color);
+}
+
+#endif
+
+#ifdef SH110X_ENABLE_STATS
+
+/*!
+    @brief  Zero all flush statistics.
+*/
+void Adafruit_SH110X::resetStats(void) { memset(&_stats, 0, sizeof(_stats)); }
+
+/*!
+    @brief  Account for the dirty window and drawPixel() calls of the frame
+            display() is about to push.
+*/
+void Adafruit_SH110X::_statDirty(void) {
+  uint32_t area = 0;
+  if ((window_x2 >= window_x1) && (window_y2 >= window_y1)) {
+    area = (uint32_t)(window_x2 - window_x1 + 1) * (window_y2 - window_y1 + 1);
+    _stats.frames++; // an empty window sends nothing, so it is no frame
+  }
+  _stats.dirtyPixels += area;
+  _stats.maxDirtyPixels = max(_stats.maxDirtyPixels, area);
+  _stats.drawPixels = _stats.pendingPixels;
+  _stats.pendingPixels = 0;
+}
+
+#endif // SH110X_ENABLE_STATS
@@ -24,6 +24,7 @@
 #ifndef _Adafruit_SH110X_H_
 #define _Adafruit_SH110X_H_
 
+#include "Adafruit_SH110X_Transport.h"
 #include <Adafruit_GrayOLED.h>
 
 /// fit into the SH110X_ naming scheme
@@ -34,6 +35,10 @@
 // Uncomment to disable Adafruit splash logo
 //#define SH110X_NO_SPLASH
 
+// Uncomment to collect flush statistics, see getStats()
+//#define SH110X_ENABLE_STATS
+// (event tracing is switched on in Adafruit_SH110X_Trace.h)
+
 #define SH110X_MEMORYMODE 0x20          ///< See datasheet
 #define SH110X_COLUMNADDR 0x21          ///< See datasheet
 #define SH110X_PAGEADDR 0x22            ///< See datasheet
@@ -62,13 +67,85 @@
   0xDC ///< Specify Column address to determine the initial display line or
        ///< COM0.
 
+#define SH110X_OSC_HZ 370000UL ///< Typical oscillator at frequency setting 5
+#define SH110X_ROW_CLOCKS 50   ///< Clocks per row besides the precharge
+
 #define SH110X_SETLOWCOLUMN 0x00  ///< Not currently used
 #define SH110X_SETHIGHCOLUMN 0x10 ///< Not currently used
 #define SH110X_SETSTARTLINE 0x40  ///< See datasheet
 
+#include "Adafruit_SH110X_Init.h"
+
+#ifdef SH110X_ENABLE_STATS
+/*!
+    @brief  Flush cost counters, accumulated since the last resetStats().
+*/
+typedef struct {
+  uint32_t frames;          ///< display() calls with a dirty area to push
+  uint32_t pages;           ///< Page runs addressed (display and direct)
+  uint32_t commandBytes;    ///< Command bytes sent (all of them)
+  uint32_t dataBytes;       ///< Display RAM bytes sent
+  uint32_t transactions;    ///< Transport write calls, failed ones too
+  uint32_t busErrors;       ///< Transport writes that failed
+  uint32_t flushMicros;     ///< Total time spent inside display()
+  uint32_t maxFlushMicros;  ///< Slowest display()
+  uint32_t dirtyPixels;     ///< Sum of dirty window areas at display()
+  uint32_t maxDirtyPixels;  ///< Largest dirty window area at display()
+  uint32_t drawPixels;      ///< drawPixel() calls before the last flush
+  uint32_t pendingPixels;   ///< drawPixel() calls since the last flush
+} sh110x_stats_t;
+#endif
+
+/*!
+    @brief  Progress of a non-blocking bring-up, see pollBegin().
+*/
+typedef enum {
+  SH110X_BEGIN_IDLE,   ///< beginAsync() not called yet
+  SH110X_BEGIN_RESET,  ///< Pulsing the reset pin
+  SH110X_BEGIN_INIT,   ///< About to set up the bus and send the init list
+  SH110X_BEGIN_SETTLE, ///< Waiting for the charge pump before display on
+  SH110X_BEGIN_READY,  ///< Display is on and usable
+  SH110X_BEGIN_FAILED, ///< Allocation or a bus write failed
+} sh110x_begin_state_t;
+
+/*!
+    @brief  Frame pacing counters, see displayPaced().
+*/
+typedef struct {
+  uint32_t frames;    ///< Paced flushes sent
+  uint32_t coalesced; ///< displayPaced() calls folded into a later flush
+  uint32_t skipped;   ///< Frame slots with nothing to send
+  uint32_t dropped;   ///< Frame slots missed while changes were waiting
+  uint32_t late;      ///< Flushes that ran past the end of their slot
+} sh110x_pacing_t;
+
+/*!
+    @brief  Controller registers shadowed by the driver, see
+            deferCommands().
+*/
+typedef enum {
+  SH110X_REG_CONTRAST,   ///< 0x81 argument
+  SH110X_REG_INVERT,     ///< 0 = 0xA6 normal, 1 = 0xA7 inverted
+  SH110X_REG_POWER,      ///< 0 = 0xAE display off, 1 = 0xAF display on
+  SH110X_REG_START_LINE, ///< 0x40 | line (SH1106) or 0xDC line (SH1107)
+  SH110X_REG_OFFSET,     ///< 0xD3 argument
+  SH110X_REG_MULTIPLEX,  ///< 0xA8 argument
+  SH110X_REG_CLOCK,      ///< 0xD5 argument
+  SH110X_REG_COUNT,      ///< Number of shadowed registers
+} sh110x_reg_t;
+
 /*!
     @brief  Class that stores state and functions for interacting with
             SH110X OLED displays. Not instantiatable - use a subclass!
+    @note   oled_command(), oled_commandList() and setContrast() replace
+            non-virtual Adafruit_GrayOLED functions so that they go
+            through the transport and register shadow. Calling them
+            through an Adafruit_GrayOLED pointer or reference is not
+            supported: it bypasses the transport (with a custom transport
+            there is no bus device for it to use at all, see the
+            transport constructor) and leaves the shadow out of step, so
+            later setters may skip writes.
+            invertDisplay() is virtual in Adafruit_GFX and safe either way.
 */
 class Adafruit_SH110X : public Adafruit_GrayOLED {
 public:
@@ -81,16 +158,155 @@ public:
   Adafruit_SH110X(uint16_t w, uint16_t h, SPIClass *spi, int16_t dc_pin,
                   int16_t rst_pin, int16_t cs_pin,
                   uint32_t bitrate = 8000000UL);
+  Adafruit_SH110X(uint16_t w, uint16_t h, Adafruit_SH110X_Transport *transport,
+                  int16_t rst_pin = -1);
 
   virtual ~Adafruit_SH110X(void) = 0;
 
+  void beginAsync(uint8_t addr = 0x3C, bool reset = true,
+                  bool framebuffer = true);
+  sh110x_begin_state_t pollBegin(void);
+  static bool beginGroup(Adafruit_SH110X *const *displays,
+                         const uint8_t *addrs, uint8_t count,
+                         bool reset = true);
+
   void display(void);
+  bool writeDisplayData(uint8_t page, uint8_t column, const uint8_t *data,
+                        uint8_t len);
+  void beginSession(void);
+  void endSession(void);
+  void releaseBuffer(void);
+  void markDirty(int16_t x1, int16_t y1, int16_t x2, int16_t y2);
+
+  void oled_command(uint8_t c);
+  bool oled_commandList(const uint8_t *c, uint8_t n);
+  void setContrast(uint8_t contrastlevel);
+  void invertDisplay(bool i);
+  void deferCommands(bool defer);
+
+  void sleep(void);
+  bool wake(void);
+  void dim(bool dim, uint8_t level = 0);
+  /*!
+    @brief  Whether sleep() has blanked the display.
+    @return true between sleep() and wake(). Not while begin() still has
+            the panel off.
+  */
+  bool isSleeping(void) const { return _sleeping; }
+
+  bool setPixelShift(int8_t lines);
+  int8_t getPixelShift(void) const;
+  void setBurnInProtection(uint8_t range, uint32_t interval_ms = 60000);
+  bool burnInTick(void);
+
+  bool setPartialDisplay(uint8_t first, uint8_t count);
+  bool exitPartialDisplay(void);
+  /*!
+    @brief  Whether setPartialDisplay() is active.
+    @return true if only a strip of the panel is scanned.
+  */
+  bool isPartialDisplay(void) const { return _partial != NULL; }
+
+  bool setDisplayClock(uint8_t frequency, uint8_t divide);
+  uint32_t setFrameRate(uint16_t hz);
+  uint32_t getFramePeriodMicros(void) const;
+
+  uint32_t setPacing(uint16_t fps, bool lock_to_panel = false);
+  bool displayPaced(void);
+  const sh110x_pacing_t &getPacingStats(void) const;
+  void resetPacingStats(void);
+
+  void setTransport(Adafruit_SH110X_Transport *transport);
+  void setProfile(const sh110x_profile_t *profile);
+  /*!
+    @brief  The transport all bus traffic currently goes through.
+    @return Pointer to the active transport, NULL before begin().
+  */
+  Adafruit_SH110X_Transport *getTransport(void) const { return _transport; }
+
+#if defined(SH110X_ENABLE_STATS) || defined(SH110X_ENABLE_TRACE)
+  void drawPixel(int16_t x, int16_t y, uint16_t color);
+#endif
+#ifdef SH110X_ENABLE_STATS
+  /*!
+    @brief  Flush statistics collected so far. Average dirty area is
+            dirtyPixels / frames.
+    @return Reference to the live counters.
+  */
+  const sh110x_stats_t &getStats(void) const { return _stats; }
+  void resetStats(void);
+#endif
 
 protected:
+  bool _init(uint8_t addr);
+  bool _beginBlocking(uint8_t addr, bool reset, bool framebuffer);
+  /*!
+    @brief  Chip-specific setup and init sequence, run once the bus is up.
+    @return true on success.
+  */
+  virtual bool _configure(void) = 0;
+  bool _applyProfile(const sh110x_profile_t *const *defaults);
+  bool _writeShifted(uint8_t page, uint8_t column, uint8_t len);
+  bool _allocShift(void);
+  bool _allocPacing(void);
+  uint32_t _framePeriod(uint8_t clk, uint8_t mux) const;
+  bool _setRegister(sh110x_reg_t reg, uint8_t value);
+  bool _flushRegisters(void);
+  bool _writePage(uint8_t page, uint8_t column, const uint8_t *data,
+                  uint8_t len);
+  bool _sendCommands(const uint8_t *cmds, uint8_t len);
+  bool _sendData(const uint8_t *data, uint8_t len);
+
   /*! some displays are 'inset' in memory, so we have to skip some memory to
    * display */
   uint8_t _page_start_offset = 0;
 
+  /*! COM lines of the controller: 64 on SH1106 (COMs along y), 128 on
+   * SH1107 (COMs along x) */
+  uint8_t _com_lines = 64;
+
+  Adafruit_SH110X_Transport *_transport = NULL; ///< Active bus transport
+  const sh110x_profile_t *_profile = NULL;      ///< Set or picked by begin()
+  /*! transport created by begin() for the I2C/SPI constructors */
+  Adafruit_SH110X_Transport *_bus_transport = NULL;
+  uint8_t _sessions = 0; ///< beginSession() nesting depth
+  /*! I2C bus of the TwoWire constructor, for a bring-up without
+   * framebuffer (GrayOLED keeps its own copy private) */
+  TwoWire *_twi = NULL;
+
+  uint8_t _regs[SH110X_REG_COUNT];      ///< Value the controller holds
+  uint8_t _regs_next[SH110X_REG_COUNT]; ///< Value waiting to be sent
+  uint8_t _regs_known = 0;              ///< Bit per register valid in _regs
+  uint8_t _regs_pending = 0;            ///< Bit per register in _regs_next
+  bool _defer_commands = false;         ///< Hold register writes for display()
+  uint8_t _contrast = 0x7F;             ///< Contrast to show when not dimmed
+  bool _dimmed = false;                 ///< dim() is active
+  bool _sleeping = false;               ///< Between sleep() and wake()
+
+  // Optional features keep their state on the heap, allocated by the first
+  // call that needs it, so displays that do not use them pay one pointer
+  struct ShiftState;
+  struct PartialState;
+  struct PacingState;
+  ShiftState *_shift = NULL;     ///< setPixelShift()/burn-in state
+  PartialState *_partial = NULL; ///< Set while in partial display mode
+  PacingState *_pacing = NULL;   ///< displayPaced() state and counters
+
+  /*! bring-up progress, see pollBegin() */
+  sh110x_begin_state_t _begin_state = SH110X_BEGIN_IDLE;
+  uint8_t _begin_addr = 0x3C;     ///< I2C address for the INIT step
+  uint8_t _begin_step = 0;        ///< Reset pulse phase
+  bool _begin_framebuffer = true; ///< INIT step allocates the framebuffer
+  uint32_t _begin_t0 = 0;         ///< millis() when the current wait began
+
+#ifdef SH110X_ENABLE_STATS
+  void _statDirty(void);
+  sh110x_stats_t _stats = {}; ///< Flush statistics
+#endif
+#ifdef SH110X_ENABLE_TRACE
+  bool _flushing = false; ///< display() is running, for overlap events
+#endif
+
 private:
 };
 
@@ -108,10 +324,16 @@ public:
   Adafruit_SH1106G(uint16_t w, uint16_t h, SPIClass *spi, int16_t dc_pin,
                    int16_t rst_pin, int16_t cs_pin,
                    uint32_t bitrate = 8000000UL);
+  Adafruit_SH1106G(uint16_t w, uint16_t h,
+                   Adafruit_SH110X_Transport *transport, int16_t rst_pin = -1);
 
   ~Adafruit_SH1106G(void);
 
-  bool begin(uint8_t i2caddr = 0x3C, bool reset = true);
+  bool begin(uint8_t i2caddr = 0x3C, bool reset = true,
+             bool framebuffer = true);
+
+protected:
+  bool _configure(void);
 };
 
 /*!
@@ -128,9 +350,15 @@ public:
   Adafruit_SH1107(uint16_t w, uint16_t h, SPIClass *spi, int16_t dc_pin,
                   int16_t rst_pin, int16_t cs_pin,
                   uint32_t bitrate = 8000000UL);
+  Adafruit_SH1107(uint16_t w, uint16_t h,
+                  Adafruit_SH110X_Transport *transport, int16_t rst_pin = -1);
 
   ~Adafruit_SH1107(void);
 
-  bool begin(uint8_t i2caddr = 0x3C, bool reset = true);
+  bool begin(uint8_t i2caddr = 0x3C, bool reset = true,
+             bool framebuffer = true);
+
+protected:
+  bool _configure(void);
 };
 #endif // _Adafruit_SH110X_H_
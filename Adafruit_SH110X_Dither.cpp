@@ -0,0 +1,254 @@
+/*!
+ * @file Adafruit_SH110X_Dither.cpp
+ *
+ */
+
+#include "Adafruit_SH110X_Dither.h"
+
+// 8x8 Bayer index matrix, scaled to 0..255 thresholds (index * 4 + 2)
+static const uint8_t bayer8[8][8] PROGMEM = {
+    {2, 130, 34, 162, 10, 138, 42, 170},
+    {194, 66, 226, 98, 202, 74, 234, 106},
+    {50, 178, 18, 146, 58, 186, 26, 154},
+    {242, 114, 210, 82, 250, 122, 218, 90},
+    {14, 142, 46, 174, 6, 134, 38, 166},
+    {206, 78, 238, 110, 198, 70, 230, 102},
+    {62, 190, 30, 158, 54, 182, 22, 150},
+    {254, 126, 222, 94, 246, 118, 214, 86},
+};
+
+/*!
+    @brief  Share of a diffused error, e * k / 2^shift rounded to nearest
+            with halves away from zero. Rounding the same way for both
+            signs keeps light and dark errors in balance; a plain shift
+            would round negative errors down and darken mid-grays.
+    @param  e
+            Quantization error.
+    @param  k
+            Weight numerator.
+    @param  shift
+            log2 of the weight denominator.
+    @return The rounded share.
+*/
+static inline int16_t share(int16_t e, int16_t k, uint8_t shift) {
+  int16_t p = e * k, half = 1 << (shift - 1);
+  return (p < 0) ? -((-p + half) >> shift) : ((p + half) >> shift);
+}
+
+/*!
+    @brief  Constructor for a grayscale dithering engine.
+    @param  display
+            Pointer to the SH110X display whose framebuffer is written.
+            Its begin() must have been called first.
+*/
+Adafruit_SH110X_Dither::Adafruit_SH110X_Dither(Adafruit_SH110X *display)
+    : _display(display) {}
+
+/*!
+    @brief  Destructor for Adafruit_SH110X_Dither object.
+*/
+Adafruit_SH110X_Dither::~Adafruit_SH110X_Dither(void) { end(); }
+
+/*!
+    @brief  Start converting an image. Rows are then passed top to bottom
+            with writeRow().
+    @param  x
+            Left edge, in native (unrotated) framebuffer coordinates. May
+            be negative.
+    @param  y
+            Top edge, in native framebuffer coordinates. May be negative.
+    @param  w
+            Image width in pixels (length of every row passed).
+    @param  h
+            Image height in pixels (number of rows expected).
+    @param  mode
+            Conversion method, see sh110x_dither_t.
+    @return true on success, false if there is no framebuffer or the row
+            buffers could not be allocated.
+    @note   Parts of the image outside the display are dropped, but error
+            diffusion still runs over the full width so the visible part
+            looks the same as if it were uncropped.
+*/
+bool Adafruit_SH110X_Dither::begin(int16_t x, int16_t y, uint16_t w,
+                                   uint16_t h, sh110x_dither_t mode) {
+  end();
+  if (!_display->getBuffer() || !w || !h) {
+    return false;
+  }
+
+  bool swap = _display->getRotation() & 1;
+  _native_w = swap ? _display->height() : _display->width();
+  _native_h = swap ? _display->width() : _display->height();
+
+  if (!(_on = (uint8_t *)malloc(w))) {
+    return false;
+  }
+  if ((mode == SH110X_DITHER_FLOYD_STEINBERG) ||
+      (mode == SH110X_DITHER_ATKINSON)) {
+    if (!(_err = (int16_t *)calloc(3 * (w + 4), sizeof(int16_t)))) {
+      end();
+      return false;
+    }
+  }
+
+  _x = x;
+  _y = y;
+  _w = w;
+  _h = h;
+  _row = 0;
+  _mode = mode;
+
+  _display->markDirty(x, y, x + w - 1, y + h - 1);
+  return true;
+}
+
+/*!
+    @brief  Convert the next row of the image into the framebuffer.
+    @param  gray
+            w bytes of 8-bit luminance, 0 = black (pixel off), 255 = white.
+    @return true if the row was consumed, false if begin() was not called
+            or all h rows were already written.
+*/
+bool Adafruit_SH110X_Dither::writeRow(const uint8_t *gray) {
+  if (!_on || (_row >= (int16_t)_h)) {
+    return false;
+  }
+
+  if (_err) {
+    _diffuse(gray, _on);
+  } else {
+    _ordered(gray, _on, (_y + _row) & 7);
+  }
+  _packRow(_on);
+
+  if (++_row >= (int16_t)_h) {
+    end();
+  }
+  return true;
+}
+
+/*!
+    @brief  Stop converting and free the row buffers. Called automatically
+            after the last row.
+*/
+void Adafruit_SH110X_Dither::end(void) {
+  free(_err);
+  free(_on);
+  _err = NULL;
+  _on = NULL;
+}
+
+/*!
+    @brief  Convenience wrapper that converts an image already in RAM.
+    @param  x
+            Left edge, in native framebuffer coordinates.
+    @param  y
+            Top edge, in native framebuffer coordinates.
+    @param  gray
+            w * h bytes of 8-bit luminance, row-major.
+    @param  w
+            Image width in pixels.
+    @param  h
+            Image height in pixels.
+    @param  mode
+            Conversion method, see sh110x_dither_t.
+    @return true on success, false if begin() failed.
+*/
+bool Adafruit_SH110X_Dither::drawImage(int16_t x, int16_t y,
+                                       const uint8_t *gray, uint16_t w,
+                                       uint16_t h, sh110x_dither_t mode) {
+  if (!begin(x, y, w, h, mode)) {
+    return false;
+  }
+  for (uint16_t r = 0; r < h; r++) {
+    writeRow(gray + (uint32_t)r * w);
+  }
+  return true;
+}
+
+/*!
+    @brief  Threshold one row against a constant or a Bayer row. Branchless
+            and over plain byte arrays so host compilers can vectorize it.
+    @param  gray
+            Input luminance row.
+    @param  on
+            Output decisions, 0xFF for a lit pixel, 0x00 otherwise.
+    @param  rowmod
+            Display row modulo 8, selecting the Bayer matrix row.
+*/
+void Adafruit_SH110X_Dither::_ordered(const uint8_t *gray, uint8_t *on,
+                                      uint8_t rowmod) {
+  uint8_t thr[8];
+  for (uint8_t i = 0; i < 8; i++) {
+    thr[i] = (_mode == SH110X_DITHER_BAYER)
+                 ? pgm_read_byte(&bayer8[rowmod][(_x + i) & 7])
+                 : 127;
+  }
+  for (uint16_t i = 0; i < _w; i++) {
+    on[i] = -(uint8_t)(gray[i] > thr[i & 7]);
+  }
+}
+
+/*!
+    @brief  Error-diffuse one row, left to right, into the decision row.
+    @param  gray
+            Input luminance row.
+    @param  on
+            Output decisions, 0xFF for a lit pixel, 0x00 otherwise.
+*/
+void Adafruit_SH110X_Dither::_diffuse(const uint8_t *gray, uint8_t *on) {
+  uint16_t stride = _w + 4;
+  // rows rotate through the three buffers; index 2 is pixel 0
+  int16_t *cur = _err + (uint16_t)(_row % 3) * stride + 2;
+  int16_t *nxt = _err + (uint16_t)((_row + 1) % 3) * stride + 2;
+  int16_t *nn = _err + (uint16_t)((_row + 2) % 3) * stride + 2;
+
+  for (uint16_t i = 0; i < _w; i++) {
+    int16_t v = gray[i] + cur[i];
+    bool lit = v > 127;
+    on[i] = lit ? 0xFF : 0x00;
+    int16_t e = v - (lit ? 255 : 0);
+
+    if (_mode == SH110X_DITHER_FLOYD_STEINBERG) {
+      cur[i + 1] += share(e, 7, 4);
+      nxt[i - 1] += share(e, 3, 4);
+      nxt[i] += share(e, 5, 4);
+      nxt[i + 1] += share(e, 1, 4);
+    } else { // Atkinson: 1/8 to six neighbours, 2/8 is dropped
+      int16_t e8 = share(e, 1, 3);
+      cur[i + 1] += e8;
+      cur[i + 2] += e8;
+      nxt[i - 1] += e8;
+      nxt[i] += e8;
+      nxt[i + 1] += e8;
+      nn[i] += e8;
+    }
+  }
+
+  // this row's buffer becomes the row after next
+  memset(cur - 2, 0, stride * sizeof(int16_t));
+}
+
+/*!
+    @brief  Merge one row of decisions into the page-format framebuffer:
+            each output pixel sets or clears one bit of a column byte.
+    @param  on
+            Decision row from _ordered() or _diffuse().
+*/
+void Adafruit_SH110X_Dither::_packRow(const uint8_t *on) {
+  int16_t y = _y + _row;
+  // only the columns on the display: [first, last)
+  int16_t first = max(_x, (int16_t)0);
+  int16_t last = min((int32_t)_x + _w, (int32_t)_native_w);
+  if ((y < 0) || (y >= (int16_t)_native_h) || (first >= last)) {
+    return;
+  }
+
+  uint8_t bit = 1 << (y & 7);
+  uint8_t keep = ~bit;
+  uint8_t *dst = _display->getBuffer() + (uint16_t)(y / 8) * _native_w;
+
+  for (int16_t x = first; x < last; x++) {
+    dst[x] = (dst[x] & keep) | (on[x - _x] & bit);
+  }
+}
@@ -0,0 +1,59 @@
+/*!
+ * @file Adafruit_SH110X_Dither.h
+ *
+ * Streaming 8-bit grayscale to 1bpp conversion for SH110X displays,
+ * writing straight into the page-format framebuffer.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#ifndef _Adafruit_SH110X_Dither_H_
+#define _Adafruit_SH110X_Dither_H_
+
+#include "Adafruit_SH110X.h"
+
+/*!
+    @brief  Grayscale to monochrome conversion methods.
+*/
+typedef enum {
+  SH110X_DITHER_THRESHOLD,       ///< Plain 50% threshold
+  SH110X_DITHER_BAYER,           ///< 8x8 Bayer ordered dither
+  SH110X_DITHER_FLOYD_STEINBERG, ///< Floyd-Steinberg error diffusion
+  SH110X_DITHER_ATKINSON,        ///< Atkinson error diffusion (6/8 spread)
+} sh110x_dither_t;
+
+/*!
+    @brief  Converts a grayscale image fed one row at a time into the
+            display's framebuffer, so the whole 8-bit image never needs to
+            be in RAM. Only the error diffusion modes allocate anything:
+            three rows of int16_t error terms.
+*/
+class Adafruit_SH110X_Dither {
+public:
+  Adafruit_SH110X_Dither(Adafruit_SH110X *display);
+  ~Adafruit_SH110X_Dither(void);
+
+  bool begin(int16_t x, int16_t y, uint16_t w, uint16_t h,
+             sh110x_dither_t mode = SH110X_DITHER_BAYER);
+  bool writeRow(const uint8_t *gray);
+  void end(void);
+
+  bool drawImage(int16_t x, int16_t y, const uint8_t *gray, uint16_t w,
+                 uint16_t h, sh110x_dither_t mode = SH110X_DITHER_BAYER);
+
+private:
+  void _packRow(const uint8_t *on);
+  void _ordered(const uint8_t *gray, uint8_t *on, uint8_t rowmod);
+  void _diffuse(const uint8_t *gray, uint8_t *on);
+
+  Adafruit_SH110X *_display;
+  int16_t *_err = NULL; ///< 3 rows of error terms, 2 guard cells each side
+  uint8_t *_on = NULL;  ///< One row of 0x00 / 0xFF output decisions
+  int16_t _x = 0, _y = 0, _row = 0;
+  uint16_t _w = 0, _h = 0;
+  uint16_t _native_w = 0, _native_h = 0;
+  sh110x_dither_t _mode = SH110X_DITHER_BAYER;
+};
+
+#endif // _Adafruit_SH110X_Dither_H_
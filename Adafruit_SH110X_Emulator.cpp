@@ -0,0 +1,338 @@
+/*!
+ * @file Adafruit_SH110X_Emulator.cpp
+ *
+ */
+
+#include "Adafruit_SH110X_Emulator.h"
+
+/*!
+    @brief  Constructor for an emulated controller and panel.
+    @param  chip
+            Controller to model, see sh110x_chip_t.
+    @param  panel_w
+            Panel width in pixels, as passed to the display constructor.
+    @param  panel_h
+            Panel height in pixels, as passed to the display constructor.
+*/
+Adafruit_SH110X_Emulator::Adafruit_SH110X_Emulator(sh110x_chip_t chip,
+                                                   uint16_t panel_w,
+                                                   uint16_t panel_h)
+    : _chip(chip), _panel_w(panel_w), _panel_h(panel_h) {
+  _ram_cols = (chip == SH110X_CHIP_SH1106) ? 132 : 128;
+  _ram_pages = (chip == SH110X_CHIP_SH1106) ? 8 : 16;
+  uint16_t seg_n = (chip == SH110X_CHIP_SH1106) ? panel_w : panel_h;
+  _seg_first = (seg_n < _ram_cols) ? (_ram_cols - seg_n) / 2 : 0;
+  powerOnReset();
+}
+
+/*!
+    @brief  Destructor for Adafruit_SH110X_Emulator object.
+*/
+Adafruit_SH110X_Emulator::~Adafruit_SH110X_Emulator(void) { free(_ram); }
+
+/*!
+    @brief  Allocate display RAM, called from the display's begin().
+    @return true on success, false if the panel does not fit the controller
+            or the RAM could not be allocated.
+*/
+bool Adafruit_SH110X_Emulator::begin(void) {
+  uint16_t seg_max = (_chip == SH110X_CHIP_SH1106) ? 132 : 128;
+  uint16_t com_max = (_chip == SH110X_CHIP_SH1106) ? 64 : 128;
+  uint16_t seg_n = (_chip == SH110X_CHIP_SH1106) ? _panel_w : _panel_h;
+  uint16_t com_n = (_chip == SH110X_CHIP_SH1106) ? _panel_h : _panel_w;
+  if (!seg_n || !com_n || (_seg_first + seg_n > seg_max) ||
+      (com_n > com_max)) {
+    return false;
+  }
+  if (!_ram && !(_ram = (uint8_t *)malloc(_ram_cols * _ram_pages))) {
+    return false;
+  }
+  // power-on RAM contents are undefined; a checkerboard makes stale
+  // areas stand out in dumps
+  for (uint16_t i = 0; i < _ram_cols * _ram_pages; i++) {
+    _ram[i] = (i & 1) ? 0xAA : 0x55;
+  }
+  return true;
+}
+
+/*!
+    @brief  Wire the panel to other SEG pins than the middle ones, as some
+            modules are. Call before begin().
+    @param  seg
+            SEG pin the panel's first segment is wired to: on the SH1106
+            the rightmost column of the unrotated image, on the SH1107 the
+            top row. A 128-wide SH1106 module wired from SEG0 uses 0.
+*/
+void Adafruit_SH110X_Emulator::setFirstSEG(uint8_t seg) { _seg_first = seg; }
+
+/*!
+    @brief  Put every register back to its datasheet reset value, as the
+            RST pin would. Display RAM is left alone.
+*/
+void Adafruit_SH110X_Emulator::powerOnReset(void) {
+  _page = _col = _rmw_col = 0;
+  _vertical = _rmw = false;
+  _start_line = _offset = 0;
+  _mux = (_chip == SH110X_CHIP_SH1106) ? 63 : 127;
+  _contrast = 0x80;
+  _seg_remap = _com_reverse = false;
+  _on = _all_on = _inverted = false;
+  _pending = -1;
+  unknownCommands = 0;
+}
+
+/*!
+    @brief  Interpret command bytes, as sent with D/C low.
+    @param  cmds
+            Command (and command argument) bytes.
+    @param  len
+            Number of bytes.
+    @return Always true.
+*/
+bool Adafruit_SH110X_Emulator::writeCommands(const uint8_t *cmds,
+                                             size_t len) {
+  while (len--) {
+    _command(*cmds++);
+  }
+  return true;
+}
+
+/*!
+    @brief  Store bytes into display RAM at the address counters, as sent
+            with D/C high.
+    @param  data
+            Display data bytes.
+    @param  len
+            Number of bytes.
+    @return false if begin() was not called, true otherwise.
+*/
+bool Adafruit_SH110X_Emulator::writeData(const uint8_t *data, size_t len) {
+  if (!_ram) {
+    return false;
+  }
+  while (len--) {
+    _data(*data++);
+  }
+  return true;
+}
+
+/*!
+    @brief  Interpret one I2C write as it appears on the wire after the
+            address byte: control bytes select command or data (D/C, bit 6)
+            and whether another control byte follows (Co, bit 7).
+    @param  buf
+            Bytes of the transaction.
+    @param  len
+            Number of bytes.
+    @return false if the transaction ends without a payload after a control
+            byte or data arrives before begin(), true otherwise.
+*/
+bool Adafruit_SH110X_Emulator::writeI2C(const uint8_t *buf, size_t len) {
+  while (len) {
+    uint8_t control = *buf++;
+    len--;
+    if (!len) {
+      return false;
+    }
+    // Co = 1: a single byte follows, then another control byte
+    size_t n = (control & 0x80) ? 1 : len;
+    bool ok = (control & 0x40) ? writeData(buf, n) : writeCommands(buf, n);
+    if (!ok) {
+      return false;
+    }
+    buf += n;
+    len -= n;
+  }
+  return true;
+}
+
+/*!
+    @brief  Decode one command byte, or the argument of a two-byte command.
+    @param  c
+            Byte received with D/C low.
+*/
+void Adafruit_SH110X_Emulator::_command(uint8_t c) {
+  bool sh1106 = (_chip == SH110X_CHIP_SH1106);
+
+  if (_pending >= 0) {
+    switch (_pending) {
+    case 0x81:
+      _contrast = c;
+      break;
+    case 0xA8:
+      _mux = c & (sh1106 ? 0x3F : 0x7F);
+      break;
+    case 0xD3:
+      _offset = c & (sh1106 ? 0x3F : 0x7F);
+      break;
+    case 0xDC:
+      _start_line = c & 0x7F;
+      break;
+    default: // DC-DC, clock, precharge, COM pins, VCOMH: no visible effect
+      break;
+    }
+    _pending = -1;
+    return;
+  }
+
+  if (c <= 0x0F) {
+    _col = (_col & 0xF0) | c;
+  } else if (c <= 0x1F) {
+    _col = (_col & 0x0F) | ((c & (sh1106 ? 0x0F : 0x07)) << 4);
+  } else if (c <= 0x21) {
+    // SH1106 has no memory mode, but the driver sends the SSD1306 one
+    _vertical = !sh1106 && (c & 1);
+  } else if (sh1106 && (c >= 0x30) && (c <= 0x33)) {
+    // pump voltage
+  } else if (sh1106 && (c >= 0x40) && (c <= 0x7F)) {
+    _start_line = c & 0x3F;
+  } else if ((c == 0x81) || (c == 0xA8) || (c == 0xAD) || (c == 0xD3) ||
+             (c == 0xD5) || (c == 0xD9) || (c == 0xDB) ||
+             (sh1106 && (c == 0xDA)) || (!sh1106 && (c == 0xDC))) {
+    _pending = c;
+  } else if ((c & 0xFE) == 0xA0) {
+    _seg_remap = c & 1;
+  } else if ((c & 0xFE) == 0xA4) {
+    _all_on = c & 1;
+  } else if ((c & 0xFE) == 0xA6) {
+    _inverted = c & 1;
+  } else if ((c & 0xFE) == 0xAE) {
+    _on = c & 1;
+  } else if ((c & 0xF0) == 0xB0) {
+    _page = c & (_ram_pages - 1);
+  } else if ((c & 0xF0) == 0xC0) {
+    _com_reverse = c & 0x08;
+  } else if (c == 0xE0) {
+    _rmw = true;
+    _rmw_col = _col;
+  } else if (c == 0xEE) {
+    if (_rmw) {
+      _col = _rmw_col;
+    }
+    _rmw = false;
+  } else if (c == 0xE3) {
+    // NOP
+  } else {
+    unknownCommands++;
+  }
+}
+
+/*!
+    @brief  Store one data byte and advance the address counters.
+    @param  d
+            Byte received with D/C high.
+*/
+void Adafruit_SH110X_Emulator::_data(uint8_t d) {
+  if (_col < _ram_cols) {
+    _ram[_page * _ram_cols + _col] = d;
+  }
+  if (_vertical) {
+    _page = (_page + 1) & (_ram_pages - 1);
+    if (!_page && (_col < _ram_cols)) {
+      _col++;
+    }
+  } else if (_col < _ram_cols) {
+    // the column counter does not wrap; writes past the end are dropped
+    _col++;
+  }
+}
+
+/*!
+    @brief  Read a bit of display RAM, ignoring the display registers.
+    @param  column
+            RAM column address.
+    @param  row
+            RAM row (page * 8 + bit).
+    @return true if the bit is set, false if not or out of range.
+*/
+bool Adafruit_SH110X_Emulator::getRAMPixel(uint16_t column,
+                                           uint16_t row) const {
+  if (!_ram || (column >= _ram_cols) || (row >= _ram_pages * 8)) {
+    return false;
+  }
+  return (_ram[(row / 8) * _ram_cols + column] >> (row & 7)) & 1;
+}
+
+/*!
+    @brief  Whether a panel pixel is lit, after start line, offset,
+            multiplex, remap, scan direction and display mode are applied.
+    @param  x
+            Column on the panel, 0 to width()-1.
+    @param  y
+            Row on the panel, 0 to height()-1.
+    @return true if lit.
+*/
+bool Adafruit_SH110X_Emulator::getPixel(uint16_t x, uint16_t y) const {
+  if (!_ram || (x >= _panel_w) || (y >= _panel_h) || !_on) {
+    return false;
+  }
+  if (_all_on) {
+    return true;
+  }
+
+  bool sh1106 = (_chip == SH110X_CHIP_SH1106);
+  uint16_t seg_max = sh1106 ? 132 : 128;
+  uint16_t com_max = sh1106 ? 64 : 128;
+  uint16_t seg_n = sh1106 ? _panel_w : _panel_h;
+  uint16_t com_n = sh1106 ? _panel_h : _panel_w;
+  uint16_t i = sh1106 ? x : y; // position along the SEG pins
+  uint16_t j = sh1106 ? y : x; // position along the COM pins
+
+  // physical pins, with the panel glued the way the driver expects
+  uint16_t seg = _seg_first + (sh1106 ? seg_n - 1 - i : i);
+  uint16_t com = (com_max - com_n) / 2 + (sh1106 ? com_n - 1 - j : j);
+
+  // pins driven at this multiplex ratio
+  uint16_t first = sh1106 ? 0 : (com_max - (_mux + 1)) / 2;
+  uint16_t last = first + _mux;
+  if ((com < first) || (com > last)) {
+    return false;
+  }
+
+  uint16_t ram_seg = _seg_remap ? seg_max - 1 - seg : seg;
+  uint16_t scan = _com_reverse ? first + last - com : com;
+  uint16_t line = (scan + _offset + _start_line) % com_max;
+
+  bool lit = sh1106 ? getRAMPixel(ram_seg, line) : getRAMPixel(line, ram_seg);
+  return lit != _inverted;
+}
+
+/*!
+    @brief  Compare the panel image with a framebuffer.
+    @param  framebuffer
+            Page-format buffer of the panel size, such as the display's
+            getBuffer() with rotation 0.
+    @return Number of pixels that differ, 0 if the panel shows exactly
+            the framebuffer.
+*/
+uint32_t
+Adafruit_SH110X_Emulator::mismatches(const uint8_t *framebuffer) const {
+  uint32_t count = 0;
+  for (uint16_t y = 0; y < _panel_h; y++) {
+    for (uint16_t x = 0; x < _panel_w; x++) {
+      bool want = (framebuffer[x + (y / 8) * _panel_w] >> (y & 7)) & 1;
+      if (want != getPixel(x, y)) {
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+/*!
+    @brief  Print the panel image as a plain (ASCII) PBM file, 1 = lit.
+    @param  out
+            Where to print, e.g. &Serial.
+*/
+void Adafruit_SH110X_Emulator::printPBM(Print *out) const {
+  out->print(F("P1\n"));
+  out->print(_panel_w);
+  out->print(' ');
+  out->println(_panel_h);
+  for (uint16_t y = 0; y < _panel_h; y++) {
+    for (uint16_t x = 0; x < _panel_w; x++) {
+      out->print(getPixel(x, y) ? '1' : '0');
+    }
+    out->print('\n');
+  }
+}
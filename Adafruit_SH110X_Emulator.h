@@ -0,0 +1,109 @@
+/*!
+ * @file Adafruit_SH110X_Emulator.h
+ *
+ * Software model of the SH1106 and SH1107 controllers. It consumes the
+ * command/data stream the driver emits (as a transport, or as raw I2C
+ * bytes) and exposes the image the panel would show, so flush strategies
+ * can be checked pixel-exact against the framebuffer without hardware.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#ifndef _Adafruit_SH110X_Emulator_H_
+#define _Adafruit_SH110X_Emulator_H_
+
+#include "Adafruit_SH110X_Transport.h"
+
+/*!
+    @brief  Controller variants understood by the emulator.
+*/
+typedef enum {
+  SH110X_CHIP_SH1106, ///< 132x64 RAM, 8 pages, COMs run along rows
+  SH110X_CHIP_SH1107, ///< 128x128 RAM, 16 pages, COMs run along columns
+} sh110x_chip_t;
+
+/*!
+    @brief  Emulated SH110X controller and attached panel.
+
+    The model covers page and column addressing, the SH1107 memory mode,
+    display start line, display offset, multiplex ratio, segment remap,
+    COM scan direction, display on/off, entire-display-on, inversion,
+    contrast and read-modify-write. Panel images are reported in the same
+    orientation as the driver's unrotated framebuffer: x along the column
+    address, y along the page bits.
+
+    The panel is assumed to be wired to the middle of the controller's SEG
+    and COM ranges (a 128-wide SH1106 panel uses SEG2..SEG129) and glued
+    so that the driver's remap/scan settings show it upright;
+    setFirstSEG() models modules wired from another SEG pin. With a
+    reduced multiplex ratio the SH1107 drives the centre COMs and the
+    SH1106 drives COM0 upwards.
+*/
+class Adafruit_SH110X_Emulator : public Adafruit_SH110X_Transport {
+public:
+  Adafruit_SH110X_Emulator(sh110x_chip_t chip, uint16_t panel_w,
+                           uint16_t panel_h);
+  ~Adafruit_SH110X_Emulator(void);
+
+  bool begin(void);
+  void powerOnReset(void);
+  void setFirstSEG(uint8_t seg);
+
+  bool writeCommands(const uint8_t *cmds, size_t len);
+  bool writeData(const uint8_t *data, size_t len);
+  bool writeI2C(const uint8_t *buf, size_t len);
+
+  bool getPixel(uint16_t x, uint16_t y) const;
+  bool getRAMPixel(uint16_t column, uint16_t row) const;
+  uint32_t mismatches(const uint8_t *framebuffer) const;
+  void printPBM(Print *out) const;
+
+  /*!
+    @brief  Panel width, along the column address.
+    @return Width in pixels.
+  */
+  uint16_t width(void) const { return _panel_w; }
+
+  /*!
+    @brief  Panel height, along the page bits.
+    @return Height in pixels.
+  */
+  uint16_t height(void) const { return _panel_h; }
+
+  /*!
+    @brief  Whether the display is switched on (0xAF).
+    @return true if on.
+  */
+  bool isOn(void) const { return _on; }
+
+  /*!
+    @brief  Last contrast value set with 0x81.
+    @return Contrast, 0-255.
+  */
+  uint8_t contrast(void) const { return _contrast; }
+
+  uint32_t unknownCommands; ///< Opcodes the model does not recognise
+
+private:
+  void _command(uint8_t c);
+  void _data(uint8_t d);
+
+  sh110x_chip_t _chip;
+  uint16_t _panel_w, _panel_h;
+  uint8_t _seg_first; ///< SEG pin wired to the panel's first segment
+  uint8_t _ram_cols, _ram_pages;
+  uint8_t *_ram = NULL;
+
+  // address counters
+  uint8_t _page, _col, _rmw_col;
+  bool _vertical, _rmw;
+
+  // display registers
+  uint8_t _start_line, _offset, _mux, _contrast;
+  bool _seg_remap, _com_reverse, _on, _all_on, _inverted;
+
+  int16_t _pending; ///< Opcode waiting for its argument byte, or -1
+};
+
+#endif // _Adafruit_SH110X_Emulator_H_
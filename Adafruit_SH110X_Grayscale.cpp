@@ -0,0 +1,225 @@
+/*!
+ * @file Adafruit_SH110X_Grayscale.cpp
+ *
+ */
+
+#include "Adafruit_SH110X_Grayscale.h"
+
+/*!
+    @brief  Constructor for a temporal grayscale surface.
+    @param  display
+            Pointer to the SH110X display to cycle planes on. Its
+            framebuffer is used as the copy of what the panel shows.
+    @param  planes
+            Number of bitplanes, 1 to SH110X_GRAY_MAX_PLANES. Gives
+            planes+1 apparent levels, 0 (off) to planes (fully on).
+    @note   Takes its native (unrotated) size from the display, so the
+            display object must be constructed first; the planes always
+            match its framebuffer whatever rotation either one has.
+*/
+Adafruit_SH110X_Grayscale::Adafruit_SH110X_Grayscale(Adafruit_SH110X *display,
+                                                     uint8_t planes)
+    : Adafruit_GFX((display->getRotation() & 1) ? display->height()
+                                                 : display->width(),
+                   (display->getRotation() & 1) ? display->width()
+                                                 : display->height()),
+      _display(display), _planes(constrain(planes, 1, SH110X_GRAY_MAX_PLANES)) {
+  for (uint8_t i = 0; i < SH110X_GRAY_MAX_PLANES; i++) {
+    _contrast[i] = -1;
+  }
+}
+
+/*!
+    @brief  Destructor for Adafruit_SH110X_Grayscale object.
+*/
+Adafruit_SH110X_Grayscale::~Adafruit_SH110X_Grayscale(void) {
+  for (uint8_t i = 0; i < SH110X_GRAY_MAX_PLANES; i++) {
+    free(_plane[i]);
+    _plane[i] = NULL;
+  }
+}
+
+/*!
+    @brief  Allocate the bitplanes, clear them and blank the panel so the
+            display framebuffer matches display RAM.
+    @return true on success, false if allocation or the bus write failed.
+    @note   The display's begin() must have been called first.
+*/
+bool Adafruit_SH110X_Grayscale::begin(void) {
+  if (!_display->getBuffer()) {
+    return false;
+  }
+  uint16_t bytes = WIDTH * ((HEIGHT + 7) / 8);
+  for (uint8_t i = 0; i < _planes; i++) {
+    if ((!_plane[i]) && !(_plane[i] = (uint8_t *)malloc(bytes))) {
+      return false;
+    }
+  }
+  fillScreen(0);
+
+  _display->clearDisplay();
+  _display->display();
+
+  _current = 0;
+  _last_contrast = -1; // the panel may have been re-initialized
+  _next_us = micros();
+  _overruns = 0;
+  return true;
+}
+
+/*!
+    @brief  Set a pixel's gray level in every plane.
+    @param  x
+            Column, in the current rotation.
+    @param  y
+            Row, in the current rotation.
+    @param  level
+            0 (off) to maxLevel() (fully on); larger values clamp.
+*/
+void Adafruit_SH110X_Grayscale::drawPixel(int16_t x, int16_t y,
+                                          uint16_t level) {
+  if ((x < 0) || (y < 0) || (x >= width()) || (y >= height())) {
+    return;
+  }
+  int16_t t;
+  switch (getRotation()) {
+  case 1:
+    t = x;
+    x = WIDTH - y - 1;
+    y = t;
+    break;
+  case 2:
+    x = WIDTH - x - 1;
+    y = HEIGHT - y - 1;
+    break;
+  case 3:
+    t = x;
+    x = y;
+    y = HEIGHT - t - 1;
+    break;
+  }
+
+  uint16_t i = x + (y / 8) * WIDTH;
+  uint8_t bit = 1 << (y & 7);
+  for (uint8_t p = 0; p < _planes; p++) {
+    if (level > p) {
+      _plane[p][i] |= bit;
+    } else {
+      _plane[p][i] &= ~bit;
+    }
+  }
+}
+
+/*!
+    @brief  Set every pixel to one gray level.
+    @param  level
+            0 (off) to maxLevel() (fully on).
+*/
+void Adafruit_SH110X_Grayscale::fillScreen(uint16_t level) {
+  uint16_t bytes = WIDTH * ((HEIGHT + 7) / 8);
+  for (uint8_t p = 0; p < _planes; p++) {
+    memset(_plane[p], (level > p) ? 0xFF : 0x00, bytes);
+  }
+}
+
+/*!
+    @brief  Set how many plane switches run() aims for per second. A full
+            gray cycle takes maxLevel() switches.
+    @param  planes_per_second
+            Switch rate, e.g. 120 for a 60 Hz cycle with 2 planes.
+*/
+void Adafruit_SH110X_Grayscale::setFrameRate(uint16_t planes_per_second) {
+  _period_us = 1000000UL / max(planes_per_second, (uint16_t)1);
+}
+
+/*!
+    @brief  Optionally change the panel contrast whenever a plane is shown,
+            to weight planes unequally for more distinct levels.
+    @param  plane
+            Plane index.
+    @param  contrast
+            Value passed to setContrast() when this plane is shown.
+*/
+void Adafruit_SH110X_Grayscale::setPlaneContrast(uint8_t plane,
+                                                 uint8_t contrast) {
+  if (plane < SH110X_GRAY_MAX_PLANES) {
+    _contrast[plane] = contrast;
+  }
+}
+
+/*!
+    @brief  Non-blocking scheduler, call as often as possible from loop().
+            Shows the next plane when its deadline is reached. Deadlines
+            advance by a fixed period so the cadence does not drift.
+    @return true if a plane was switched on this call.
+*/
+bool Adafruit_SH110X_Grayscale::run(void) {
+  uint32_t now = micros();
+  if ((int32_t)(now - _next_us) < 0) {
+    return false;
+  }
+  if ((now - _next_us) > _period_us) { // more than a period behind: resync
+    _overruns++;
+    _next_us = now;
+  }
+  _next_us += _period_us;
+
+  return showPlane((_current + 1) % _planes);
+}
+
+/*!
+    @brief  Put one plane on the panel, sending only the runs of column
+            bytes that differ from what it currently shows. Runs closer
+            than SH110X_GRAY_RUN_GAP bytes are merged, since re-addressing
+            costs more than sending a few unchanged bytes.
+    @param  plane
+            Plane index.
+    @return true on success, false if a bus write failed.
+*/
+bool Adafruit_SH110X_Grayscale::showPlane(uint8_t plane) {
+  uint8_t *shown = _display->getBuffer();
+  if ((plane >= _planes) || !shown || !_plane[plane]) {
+    return false;
+  }
+  const uint8_t *src = _plane[plane];
+  uint8_t pages = (HEIGHT + 7) / 8;
+  bool ok = true;
+
+  // one bus session per plane switch, not one per diff run
+  _display->beginSession();
+  for (uint8_t p = 0; ok && (p < pages); p++) {
+    uint16_t row = (uint16_t)p * WIDTH;
+    int16_t x = 0;
+    while (ok && (x < WIDTH)) {
+      if (src[row + x] == shown[row + x]) {
+        x++;
+        continue;
+      }
+      int16_t start = x, end = x;
+      while ((x < WIDTH) && (x - end <= SH110X_GRAY_RUN_GAP)) {
+        if (src[row + x] != shown[row + x]) {
+          end = x;
+        }
+        x++;
+      }
+      uint8_t len = end - start + 1;
+      ok = _display->writeDisplayData(p, start, src + row + start, len);
+      if (ok) {
+        memcpy(shown + row + start, src + row + start, len);
+      }
+    }
+  }
+
+  if (ok && (_contrast[plane] >= 0) &&
+      (_contrast[plane] != _last_contrast)) {
+    _display->setContrast(_contrast[plane]);
+    _last_contrast = _contrast[plane];
+  }
+  _display->endSession();
+  if (!ok) {
+    return false;
+  }
+
+  _current = plane;
+  return true;
+}
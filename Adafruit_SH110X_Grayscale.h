@@ -0,0 +1,64 @@
+/*!
+ * @file Adafruit_SH110X_Grayscale.h
+ *
+ * Temporal grayscale for 1-bit SH110X displays: several bitplanes are
+ * shown in turn, fast enough that the eye averages them into gray levels.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#ifndef _Adafruit_SH110X_Grayscale_H_
+#define _Adafruit_SH110X_Grayscale_H_
+
+#include "Adafruit_SH110X.h"
+
+#define SH110X_GRAY_MAX_PLANES 4 ///< Up to 5 apparent levels
+#define SH110X_GRAY_RUN_GAP 4    ///< Merge diff runs closer than this
+
+/*!
+    @brief  A GFX drawing surface with planes+1 gray levels. Levels are
+            thermometer coded (plane i is lit where level > i), so adjacent
+            planes differ only at edges and each plane switch sends only
+            the bytes that differ from what the panel currently shows.
+*/
+class Adafruit_SH110X_Grayscale : public Adafruit_GFX {
+public:
+  Adafruit_SH110X_Grayscale(Adafruit_SH110X *display, uint8_t planes = 2);
+  ~Adafruit_SH110X_Grayscale(void);
+
+  bool begin(void);
+  void drawPixel(int16_t x, int16_t y, uint16_t level);
+  void fillScreen(uint16_t level);
+
+  void setFrameRate(uint16_t planes_per_second);
+  void setPlaneContrast(uint8_t plane, uint8_t contrast);
+  bool run(void);
+  bool showPlane(uint8_t plane);
+
+  /*!
+    @brief  Highest gray level (all planes lit).
+    @return Number of planes.
+  */
+  uint8_t maxLevel(void) const { return _planes; }
+
+  /*!
+    @brief  Plane switches that started more than one period late since
+            begin(); a nonzero count means the bus cannot keep up.
+    @return Number of missed deadlines.
+  */
+  uint32_t overruns(void) const { return _overruns; }
+
+private:
+  Adafruit_SH110X *_display;
+  uint8_t *_plane[SH110X_GRAY_MAX_PLANES] = {NULL};
+  int16_t _contrast[SH110X_GRAY_MAX_PLANES]; ///< -1 = leave contrast alone
+  uint8_t _planes;
+  uint8_t _current = 0;
+  int16_t _last_contrast = -1;
+  uint32_t _period_us = 16667;
+  uint32_t _next_us = 0;
+  uint32_t _overruns = 0;
+};
+
+#endif // _Adafruit_SH110X_Grayscale_H_
@@ -0,0 +1,56 @@
+/*!
+ * @file Adafruit_SH110X_Init.cpp
+ *
+ */
+
+#include "Adafruit_SH110X.h"
+
+// clang-format off
+// clockDiv, multiplex, offset, startLine, segRemap, comScan, comPins, pump,
+// dcdc, contrast, vcom, precharge
+static constexpr sh110x_panel_t sh1106_128x64 = {
+    0x80, 0x3F, 0x00, 0, 1, SH110X_COMSCANDEC, 0x12, 0x33,
+    0x8B, 0xFF, 0x40, 0x1F,
+};
+static constexpr sh110x_panel_t sh1107_64x128 = {
+    0x51, 0x3F, 0x60, 0, 0, SH110X_COMSCANINC, 0, 0,
+    0x8A, 0x4F, 0x35, 0x22,
+};
+static constexpr sh110x_panel_t sh1107_128x128 = {
+    0x51, 0x7F, 0x00, 0, 0, SH110X_COMSCANINC, 0, 0,
+    0x8A, 0x4F, 0x35, 0x22,
+};
+// clang-format on
+
+static constexpr sh110x_init_seq_t<SH1106_INIT_LEN> sh1106_128x64_init =
+    sh1106_initSequence(sh1106_128x64);
+static constexpr sh110x_init_seq_t<SH1107_INIT_LEN> sh1107_64x128_init =
+    sh1107_initSequence(sh1107_64x128);
+static constexpr sh110x_init_seq_t<SH1107_INIT_LEN> sh1107_128x128_init =
+    sh1107_initSequence(sh1107_128x128);
+
+// width, height, columnOffset, contrast, offset, multiplex, clockDiv,
+// precharge, init, initLen. The SH1106 init sets segment remap, which maps
+// RAM column c to SEG131-c: a panel on SEG2..SEG129 starts at column 2, one
+// on SEG0..SEG127 at column 4.
+const sh110x_profile_t SH1106_PROFILE_128X64 = {
+    128, 64, 2, sh1106_128x64.contrast, sh1106_128x64.offset,
+    sh1106_128x64.multiplex, sh1106_128x64.clockDiv, sh1106_128x64.precharge,
+    sh1106_128x64_init.bytes, SH1106_INIT_LEN};
+const sh110x_profile_t SH1106_PROFILE_128X64_SEG0 = {
+    128, 64, 4, sh1106_128x64.contrast, sh1106_128x64.offset,
+    sh1106_128x64.multiplex, sh1106_128x64.clockDiv, sh1106_128x64.precharge,
+    sh1106_128x64_init.bytes, SH1106_INIT_LEN};
+const sh110x_profile_t SH1107_PROFILE_64X128 = {
+    64, 128, 0, sh1107_64x128.contrast, sh1107_64x128.offset,
+    sh1107_64x128.multiplex, sh1107_64x128.clockDiv, sh1107_64x128.precharge,
+    sh1107_64x128_init.bytes, SH1107_INIT_LEN};
+const sh110x_profile_t SH1107_PROFILE_128X128 = {
+    128, 128, 0, sh1107_128x128.contrast, sh1107_128x128.offset,
+    sh1107_128x128.multiplex, sh1107_128x128.clockDiv, sh1107_128x128.precharge,
+    sh1107_128x128_init.bytes, SH1107_INIT_LEN};
+
+const sh110x_profile_t *const SH1106_PROFILES[] = {&SH1106_PROFILE_128X64,
+                                                   NULL};
+const sh110x_profile_t *const SH1107_PROFILES[] = {
+    &SH1107_PROFILE_64X128, &SH1107_PROFILE_128X128, NULL};
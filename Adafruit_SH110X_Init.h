@@ -0,0 +1,200 @@
+/*!
+ * @file Adafruit_SH110X_Init.h
+ *
+ * Compile-time builder for SH110X init sequences. A panel is described by
+ * the register values it needs; the builder lays them out as the command
+ * stream for the chip, checking the values while compiling, so the tables
+ * in begin() cannot silently miss or misplace an argument byte.
+ *
+ * Panel profiles pair a built sequence with the geometry and RAM offset
+ * of one kind of module, so supporting another module means adding a
+ * table entry rather than driver code.
+ *
+ * Included by Adafruit_SH110X.h, after the command definitions.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#ifndef _Adafruit_SH110X_Init_H_
+#define _Adafruit_SH110X_Init_H_
+
+#include <Arduino.h>
+
+/*!
+    @brief  Register values that make up a panel's init sequence. Fields
+            are listed in the order they must be given; every panel ends
+            with a non-zero precharge, so a description that stops early
+            does not compile.
+*/
+typedef struct {
+  uint8_t clockDiv;  ///< 0xD5: oscillator frequency and clock divide ratio
+  uint8_t multiplex; ///< 0xA8: COM lines driven, minus one
+  uint8_t offset;    ///< 0xD3: display offset
+  uint8_t startLine; ///< 0x40 (SH1106) or 0xDC (SH1107): display start line
+  uint8_t segRemap;  ///< 0 or 1, added to SH110X_SEGREMAP
+  uint8_t comScan;   ///< SH110X_COMSCANINC or SH110X_COMSCANDEC
+  uint8_t comPins;   ///< 0xDA: COM pin configuration, SH1106 only
+  uint8_t pump;      ///< 0x30-0x33: charge pump voltage, SH1106 only
+  uint8_t dcdc;      ///< 0xAD: DC-DC control, 0x8A off or 0x8B on
+  uint8_t contrast;  ///< 0x81: contrast
+  uint8_t vcom;      ///< 0xDB: VCOM deselect level
+  uint8_t precharge; ///< 0xD9: discharge/precharge periods, both non-zero
+} sh110x_panel_t;
+
+/*!
+    @brief  A built command stream, sized at compile time.
+    @tparam N
+            Number of command bytes.
+*/
+template <size_t N> struct sh110x_init_seq_t {
+  uint8_t bytes[N]; ///< Commands and their arguments, in send order
+
+  /*!
+    @brief  Length of the stream, for oled_commandList().
+    @return Number of bytes.
+  */
+  constexpr size_t size(void) const { return N; }
+};
+
+#define SH1106_INIT_LEN 25 ///< Bytes emitted by sh1106_initSequence()
+#define SH1107_INIT_LEN 22 ///< Bytes emitted by sh1107_initSequence()
+
+/*!
+    @brief  Pack command bytes into a sequence of exactly N bytes.
+    @tparam N
+            Expected length; a layout with more or fewer bytes does not
+            compile, so no argument can go missing.
+    @param  b
+            The bytes.
+    @return The sequence.
+*/
+template <size_t N, typename... T>
+constexpr sh110x_init_seq_t<N> sh110x_initBytes(T... b) {
+  static_assert(sizeof...(T) == N, "init sequence length mismatch");
+  return sh110x_init_seq_t<N>{{(uint8_t)b...}};
+}
+
+/*!
+    @brief  Not constexpr on purpose: reaching it while building a
+            sequence in a constant expression stops the compile, and the
+            error names it. Never defined.
+    @return Nothing.
+*/
+uint8_t sh110x_invalid_panel_description(void);
+
+/*!
+    @brief  Check the fields both chips share.
+    @param  p
+            Panel description.
+    @param  lines
+            Number of COM lines of the chip.
+    @return true if every field is in range.
+*/
+constexpr bool sh110x_panelValid(const sh110x_panel_t &p, uint8_t lines) {
+  return (p.multiplex >= 15) && (p.multiplex < lines) && (p.offset < lines) &&
+         (p.startLine < lines) && (p.segRemap <= 1) &&
+         ((p.comScan == SH110X_COMSCANINC) ||
+          (p.comScan == SH110X_COMSCANDEC)) &&
+         ((p.dcdc & 0xFE) == 0x8A) && (p.precharge & 0x0F) &&
+         (p.precharge & 0xF0);
+}
+
+/*!
+    @brief  Lay out an SH1106 init sequence. Use it to initialize a
+            constexpr (or static constexpr) variable so it runs while
+            compiling.
+    @param  p
+            Panel description; comPins and pump are used.
+    @return The command stream, display left off.
+*/
+constexpr sh110x_init_seq_t<SH1106_INIT_LEN>
+sh1106_initSequence(const sh110x_panel_t &p) {
+  // clang-format off
+  return (sh110x_panelValid(p, 64) && ((p.pump & 0xFC) == 0x30))
+      ? sh110x_initBytes<SH1106_INIT_LEN>(
+            SH110X_DISPLAYOFF,
+            SH110X_SETDISPLAYCLOCKDIV, p.clockDiv,
+            SH110X_SETMULTIPLEX, p.multiplex,
+            SH110X_SETDISPLAYOFFSET, p.offset,
+            SH110X_SETSTARTLINE | p.startLine,
+            SH110X_DCDC, p.dcdc,
+            SH110X_SEGREMAP + p.segRemap,
+            p.comScan,
+            SH110X_SETCOMPINS, p.comPins,
+            SH110X_SETCONTRAST, p.contrast,
+            SH110X_SETPRECHARGE, p.precharge,
+            SH110X_SETVCOMDETECT, p.vcom,
+            p.pump,
+            SH110X_NORMALDISPLAY,
+            SH110X_MEMORYMODE, 0x10,
+            SH110X_DISPLAYALLON_RESUME)
+      : sh110x_init_seq_t<SH1106_INIT_LEN>{
+            {sh110x_invalid_panel_description()}};
+  // clang-format on
+}
+
+/*!
+    @brief  Lay out an SH1107 init sequence. Use it to initialize a
+            constexpr (or static constexpr) variable so it runs while
+            compiling.
+    @param  p
+            Panel description; comPins and pump are ignored.
+    @return The command stream, display left off.
+*/
+constexpr sh110x_init_seq_t<SH1107_INIT_LEN>
+sh1107_initSequence(const sh110x_panel_t &p) {
+  // clang-format off
+  return sh110x_panelValid(p, 128)
+      ? sh110x_initBytes<SH1107_INIT_LEN>(
+            SH110X_DISPLAYOFF,
+            SH110X_SETDISPLAYCLOCKDIV, p.clockDiv,
+            SH110X_MEMORYMODE,
+            SH110X_SETCONTRAST, p.contrast,
+            SH110X_DCDC, p.dcdc,
+            SH110X_SEGREMAP + p.segRemap,
+            p.comScan,
+            SH110X_SETDISPSTARTLINE, p.startLine,
+            SH110X_SETDISPLAYOFFSET, p.offset,
+            SH110X_SETPRECHARGE, p.precharge,
+            SH110X_SETVCOMDETECT, p.vcom,
+            SH110X_SETMULTIPLEX, p.multiplex,
+            SH110X_DISPLAYALLON_RESUME,
+            SH110X_NORMALDISPLAY)
+      : sh110x_init_seq_t<SH1107_INIT_LEN>{
+            {sh110x_invalid_panel_description()}};
+  // clang-format on
+}
+
+/*!
+    @brief  One kind of panel module: the size it applies to, where it sits
+            in display RAM and the init sequence that sets it up. To add a
+            module, build its sequence into a constexpr variable and point
+            a profile at it, as Adafruit_SH110X_Init.cpp does.
+*/
+typedef struct {
+  uint16_t width;       ///< Panel width, as passed to the constructor
+  uint16_t height;      ///< Panel height, as passed to the constructor
+  uint8_t columnOffset; ///< First display RAM column the panel is wired to
+  uint8_t contrast;     ///< Contrast the init sequence sets
+  uint8_t offset;       ///< Display offset the init sequence sets
+  uint8_t multiplex;    ///< Multiplex ratio the init sequence sets
+  uint8_t clockDiv;     ///< Clock setting the init sequence sets
+  uint8_t precharge;    ///< Precharge periods the init sequence sets
+  const uint8_t *init;  ///< Init sequence, display left off
+  uint8_t initLen;      ///< Bytes in init
+} sh110x_profile_t;
+
+extern const sh110x_profile_t SH1106_PROFILE_128X64; ///< SEG2-129, 1.3" modules
+extern const sh110x_profile_t
+    SH1106_PROFILE_128X64_SEG0; ///< Clones wired from SEG0
+extern const sh110x_profile_t SH1107_PROFILE_64X128;  ///< 128x64 FeatherWing
+extern const sh110x_profile_t SH1107_PROFILE_128X128; ///< 128x128 modules
+
+/// Profiles picked by size when none is set, NULL-terminated; the first
+/// entry is used for sizes not listed
+extern const sh110x_profile_t *const SH1106_PROFILES[];
+/// SH1107 counterpart of SH1106_PROFILES
+extern const sh110x_profile_t *const SH1107_PROFILES[];
+
+#endif // _Adafruit_SH110X_Init_H_
@@ -0,0 +1,117 @@
+/*!
+ * @file Adafruit_SH110X_TextField.cpp
+ *
+ */
+
+#include "Adafruit_SH110X_TextField.h"
+
+/*!
+    @brief  Constructor for a fixed-pitch text field.
+    @param  display
+            Pointer to the SH110X display the field draws into.
+    @param  x
+            Left edge of the field, in the display's (rotated) coordinates.
+    @param  y
+            Top edge of the field. Placing it on a multiple of 8 (in an
+            unrotated display) keeps each cell inside a single page, so a
+            changed character costs one page segment on the bus.
+    @param  columns
+            Width of the field in characters.
+    @param  size
+            Text magnification; each cell is 6*size by 8*size pixels.
+    @note   Cells are drawn with drawChar() and the classic built-in font.
+            Proportional fonts set with setFont() are not fixed pitch and
+            must not be active while the field is updated.
+*/
+Adafruit_SH110X_TextField::Adafruit_SH110X_TextField(Adafruit_SH110X *display,
+                                                     int16_t x, int16_t y,
+                                                     uint8_t columns,
+                                                     uint8_t size)
+    : _display(display), _x(x), _y(y), _columns(columns),
+      _size(size ? size : 1) {}
+
+/*!
+    @brief  Destructor for Adafruit_SH110X_TextField object.
+*/
+Adafruit_SH110X_TextField::~Adafruit_SH110X_TextField(void) {
+  if (_shadow) {
+    free(_shadow);
+    _shadow = NULL;
+  }
+}
+
+/*!
+    @brief  Allocate RAM for the per-cell shadow copy of the text.
+    @return true on successful allocation, false otherwise.
+*/
+bool Adafruit_SH110X_TextField::begin(void) {
+  if ((!_shadow) && !(_shadow = (char *)malloc(_columns))) {
+    return false;
+  }
+  invalidate();
+  return true;
+}
+
+/*!
+    @brief  Set the foreground and background colors of the field. The
+            background is always painted so a cell fully replaces the
+            previous glyph. Forces a full redraw on the next update.
+    @param  color
+            Text color (SH110X_WHITE or SH110X_BLACK).
+    @param  bg
+            Background color, must differ from color.
+*/
+void Adafruit_SH110X_TextField::setTextColor(uint16_t color, uint16_t bg) {
+  _color = color;
+  _bg = bg;
+  invalidate();
+}
+
+/*!
+    @brief  Render a new string into the field. Strings shorter than the
+            field are padded with spaces, longer ones are truncated. Only
+            cells whose character differs from the previous update are
+            drawn, so only they extend the display's dirty window.
+    @param  str
+            Null-terminated string to show.
+    @return Number of cells that were re-rendered.
+    @note   Call display() afterwards to push the changed cells.
+*/
+uint8_t Adafruit_SH110X_TextField::update(const char *str) {
+  if (!_shadow) {
+    return 0;
+  }
+
+  uint8_t changed = 0;
+  bool ended = false;
+
+  for (uint8_t i = 0; i < _columns; i++) {
+    char c = ' ';
+    if (!ended) {
+      if (str[i]) {
+        c = str[i];
+      } else {
+        ended = true;
+      }
+    }
+    if (_shadow[i] == c) {
+      continue;
+    }
+    _display->drawChar(_x + (int16_t)i * 6 * _size, _y, c, _color, _bg,
+                       _size);
+    _shadow[i] = c;
+    changed++;
+  }
+
+  return changed;
+}
+
+/*!
+    @brief  Forget what was last rendered, so the next update() redraws
+            every cell. Use after clearDisplay() or drawing over the field.
+*/
+void Adafruit_SH110X_TextField::invalidate(void) {
+  if (_shadow) {
+    memset(_shadow, 0, _columns);
+  }
+}
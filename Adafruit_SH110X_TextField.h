@@ -0,0 +1,46 @@
+/*!
+ * @file Adafruit_SH110X_TextField.h
+ *
+ * Fixed-pitch text field for SH110X displays that only re-renders the
+ * character cells whose contents changed since the last update.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#ifndef _Adafruit_SH110X_TextField_H_
+#define _Adafruit_SH110X_TextField_H_
+
+#include "Adafruit_SH110X.h"
+
+/*!
+    @brief  A one-line text region drawn with the classic 6x8 GFX font.
+            Remembers the last string rendered and, on update, redraws
+            (and so marks dirty) only the cells that changed.
+*/
+class Adafruit_SH110X_TextField {
+public:
+  Adafruit_SH110X_TextField(Adafruit_SH110X *display, int16_t x, int16_t y,
+                            uint8_t columns, uint8_t size = 1);
+  ~Adafruit_SH110X_TextField(void);
+
+  bool begin(void);
+  void setTextColor(uint16_t color, uint16_t bg);
+  uint8_t update(const char *str);
+  void invalidate(void);
+
+  /*!
+    @brief  Number of character cells in the field.
+    @return Width of the field in characters.
+  */
+  uint8_t columns(void) const { return _columns; }
+
+private:
+  Adafruit_SH110X *_display;
+  char *_shadow = NULL; ///< Last character drawn in each cell, 0 if never
+  int16_t _x, _y;
+  uint16_t _color = SH110X_WHITE, _bg = SH110X_BLACK;
+  uint8_t _columns, _size;
+};
+
+#endif // _Adafruit_SH110X_TextField_H_
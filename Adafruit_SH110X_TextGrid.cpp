@@ -0,0 +1,263 @@
+/*!
+ * @file Adafruit_SH110X_TextGrid.cpp
+ *
+ */
+
+#include "Adafruit_SH110X_TextGrid.h"
+#include <glcdfont.c>
+
+/*!
+    @brief  Constructor for a character-cell text front end.
+    @param  display
+            Pointer to the SH110X display to render into. This object's
+            begin() brings it up, instead of the display's own begin().
+*/
+Adafruit_SH110X_TextGrid::Adafruit_SH110X_TextGrid(Adafruit_SH110X *display)
+    : _display(display) {}
+
+/*!
+    @brief  Destructor for Adafruit_SH110X_TextGrid object.
+*/
+Adafruit_SH110X_TextGrid::~Adafruit_SH110X_TextGrid(void) {
+  free(_cells);
+  free(_dirty);
+  _cells = NULL;
+  _dirty = NULL;
+}
+
+/*!
+    @brief  Allocate the character grid and dirty bits, sized to fill the
+            display in its native orientation (e.g. 21x16 on 128x128), and
+            bring the display up without a framebuffer, so only the grid
+            is ever resident. GFX drawing on the display must not be used.
+    @param  addr
+            I2C address of the display, ignored for SPI.
+    @param  reset
+            If true and the display has a reset pin, hard-reset it first.
+    @return true on success, false if allocation or bring-up failed.
+    @note   Everything is marked dirty, so the first display() call clears
+            whatever is left in display RAM.
+*/
+bool Adafruit_SH110X_TextGrid::begin(uint8_t addr, bool reset) {
+  // native (rotation 0) geometry, regardless of current GFX rotation
+  bool swap = _display->getRotation() & 1;
+  uint16_t w = swap ? _display->height() : _display->width();
+  uint16_t h = swap ? _display->width() : _display->height();
+
+  _width = w;
+  _cols = w / SH110X_TEXTGRID_CELL_WIDTH;
+  _rows = h / 8;
+
+  uint16_t cells = (uint16_t)_cols * _rows;
+  if ((!_cells) && !(_cells = (char *)malloc(cells))) {
+    return false;
+  }
+  if ((!_dirty) && !(_dirty = (uint8_t *)malloc((cells + 7) / 8))) {
+    return false;
+  }
+
+  _display->beginAsync(addr, reset, false);
+  sh110x_begin_state_t state;
+  while (((state = _display->pollBegin()) != SH110X_BEGIN_READY) &&
+         (state != SH110X_BEGIN_FAILED)) {
+    delay(1);
+  }
+  if (state == SH110X_BEGIN_FAILED) {
+    return false;
+  }
+
+  clear();
+  return true;
+}
+
+/*!
+    @brief  Blank every cell and home the cursor.
+*/
+void Adafruit_SH110X_TextGrid::clear(void) {
+  uint16_t cells = (uint16_t)_cols * _rows;
+  memset(_cells, ' ', cells);
+  memset(_dirty, 0xFF, (cells + 7) / 8);
+  _margin_dirty = true;
+  _cursor_col = _cursor_row = 0;
+}
+
+/*!
+    @brief  Place a character in a cell, marking it dirty only if it
+            changed.
+    @param  col
+            Cell column, 0 to columns()-1.
+    @param  row
+            Cell row, 0 to rows()-1.
+    @param  c
+            Character to show.
+*/
+void Adafruit_SH110X_TextGrid::setCell(uint8_t col, uint8_t row, char c) {
+  if ((col >= _cols) || (row >= _rows)) {
+    return;
+  }
+  uint16_t cell = (uint16_t)row * _cols + col;
+  if (_cells[cell] != c) {
+    _cells[cell] = c;
+    _markDirty(cell);
+  }
+}
+
+/*!
+    @brief  Read back the character in a cell.
+    @param  col
+            Cell column.
+    @param  row
+            Cell row.
+    @return The character, or 0 if out of range.
+*/
+char Adafruit_SH110X_TextGrid::getCell(uint8_t col, uint8_t row) const {
+  if ((col >= _cols) || (row >= _rows)) {
+    return 0;
+  }
+  return _cells[(uint16_t)row * _cols + col];
+}
+
+/*!
+    @brief  Move the cursor used by print()/write().
+    @param  col
+            Cell column.
+    @param  row
+            Cell row.
+*/
+void Adafruit_SH110X_TextGrid::setCursor(uint8_t col, uint8_t row) {
+  _cursor_col = min(col, _cols);
+  _cursor_row = min(row, (uint8_t)(_rows - 1));
+}
+
+/*!
+    @brief  Scroll the grid up by one row and blank the last row. Only
+            cells whose character actually changes are marked dirty.
+*/
+void Adafruit_SH110X_TextGrid::scroll(void) {
+  for (uint8_t row = 0; row < _rows; row++) {
+    for (uint8_t col = 0; col < _cols; col++) {
+      char c = (row + 1 < _rows) ? getCell(col, row + 1) : ' ';
+      setCell(col, row, c);
+    }
+  }
+}
+
+/*!
+    @brief  Print one character at the cursor, handling newlines, wrapping
+            at the right edge and scrolling at the bottom.
+    @param  c
+            Character to print.
+    @return 1
+*/
+size_t Adafruit_SH110X_TextGrid::write(uint8_t c) {
+  if (c == '\r') {
+    _cursor_col = 0;
+    return 1;
+  }
+  if ((c == '\n') || (_cursor_col >= _cols)) {
+    _cursor_col = 0;
+    if (++_cursor_row >= _rows) {
+      scroll();
+      _cursor_row = _rows - 1;
+    }
+    if (c == '\n') {
+      return 1;
+    }
+  }
+  setCell(_cursor_col++, _cursor_row, c);
+  return 1;
+}
+
+/*!
+    @brief  Render every dirty cell straight into display RAM. Runs of
+            adjacent dirty cells in a row share one page/column address,
+            so a lone changed cell costs its 6 glyph bytes plus addressing.
+    @return true on success, false if a bus write failed (the failed cells
+            stay dirty).
+*/
+bool Adafruit_SH110X_TextGrid::display(void) {
+  // one bus session for the whole grid, not one per run of cells
+  _display->beginSession();
+  bool ok = _flushCells();
+  _display->endSession();
+  return ok;
+}
+
+/*!
+    @brief  Render the dirty cells and margins, inside a session opened by
+            display().
+    @return true on success, false if a bus write failed.
+*/
+bool Adafruit_SH110X_TextGrid::_flushCells(void) {
+  uint8_t chunk[SH110X_TEXTGRID_CHUNK];
+
+  for (uint8_t row = 0; row < _rows; row++) {
+    if (_margin_dirty && !_flushMargin(row)) {
+      return false;
+    }
+
+    uint8_t col = 0;
+    while (col < _cols) {
+      uint16_t cell = (uint16_t)row * _cols + col;
+      if (!(_dirty[cell / 8] & (1 << (cell & 7)))) {
+        col++;
+        continue;
+      }
+
+      // gather a run of dirty cells, rendered glyph column by column
+      uint8_t first = col, len = 0;
+      while ((col < _cols) &&
+             (len + SH110X_TEXTGRID_CELL_WIDTH <= SH110X_TEXTGRID_CHUNK)) {
+        cell = (uint16_t)row * _cols + col;
+        if (!(_dirty[cell / 8] & (1 << (cell & 7)))) {
+          break;
+        }
+        uint8_t c = _cells[cell];
+        if (!_cp437 && (c >= 176)) {
+          c++; // Handle 'classic' charset behavior
+        }
+        for (uint8_t i = 0; i < 5; i++) {
+          chunk[len++] = pgm_read_byte(&font[c * 5 + i]);
+        }
+        chunk[len++] = 0x00;
+        col++;
+      }
+
+      if (!_display->writeDisplayData(
+              row, first * SH110X_TEXTGRID_CELL_WIDTH, chunk, len)) {
+        return false;
+      }
+      for (uint8_t i = first; i < col; i++) {
+        cell = (uint16_t)row * _cols + i;
+        _dirty[cell / 8] &= ~(1 << (cell & 7));
+      }
+    }
+  }
+
+  _margin_dirty = false;
+  return true;
+}
+
+/*!
+    @brief  Set the dirty bit of one cell.
+    @param  cell
+            Row-major cell index.
+*/
+void Adafruit_SH110X_TextGrid::_markDirty(uint16_t cell) {
+  _dirty[cell / 8] |= (1 << (cell & 7));
+}
+
+/*!
+    @brief  Blank the columns right of the last full cell on one page.
+    @param  page
+            Page (row of cells) to clear.
+    @return true on success, false if the bus write failed.
+*/
+bool Adafruit_SH110X_TextGrid::_flushMargin(uint8_t page) {
+  uint8_t start = _cols * SH110X_TEXTGRID_CELL_WIDTH;
+  if (start >= _width) {
+    return true;
+  }
+  uint8_t blank[SH110X_TEXTGRID_CELL_WIDTH] = {0};
+  return _display->writeDisplayData(page, start, blank, _width - start);
+}
@@ -0,0 +1,76 @@
+/*!
+ * @file Adafruit_SH110X_TextGrid.h
+ *
+ * Character-cell text mode for SH110X displays. Keeps only a grid of
+ * characters plus a dirty bit per cell instead of a full framebuffer, and
+ * renders glyph columns straight into display RAM when flushed.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#ifndef _Adafruit_SH110X_TextGrid_H_
+#define _Adafruit_SH110X_TextGrid_H_
+
+#include "Adafruit_SH110X.h"
+
+#define SH110X_TEXTGRID_CELL_WIDTH 6 ///< 5 glyph columns plus 1 spacing
+#define SH110X_TEXTGRID_CHUNK 30     ///< Glyph bytes per bus write
+
+/*!
+    @brief  Text-only front end for an SH110X display. Each cell is one
+            6x8 character in the display's native (unrotated) orientation,
+            so a row of cells is exactly one page of display RAM.
+*/
+class Adafruit_SH110X_TextGrid : public Print {
+public:
+  Adafruit_SH110X_TextGrid(Adafruit_SH110X *display);
+  ~Adafruit_SH110X_TextGrid(void);
+
+  bool begin(uint8_t addr = 0x3C, bool reset = true);
+  bool display(void);
+
+  void clear(void);
+  void setCell(uint8_t col, uint8_t row, char c);
+  char getCell(uint8_t col, uint8_t row) const;
+  void setCursor(uint8_t col, uint8_t row);
+  void scroll(void);
+
+  /*!
+    @brief  Enable or disable the correct CP437 character set, see
+            Adafruit_GFX::cp437().
+    @param  x
+            true = enable (new behavior), false = disable (old behavior)
+  */
+  void cp437(bool x = true) { _cp437 = x; }
+
+  /*!
+    @brief  Number of character columns in the grid.
+    @return Grid width in cells.
+  */
+  uint8_t columns(void) const { return _cols; }
+
+  /*!
+    @brief  Number of character rows (display pages) in the grid.
+    @return Grid height in cells.
+  */
+  uint8_t rows(void) const { return _rows; }
+
+  using Print::write;
+  size_t write(uint8_t c);
+
+private:
+  void _markDirty(uint16_t cell);
+  bool _flushCells(void);
+  bool _flushMargin(uint8_t page);
+
+  Adafruit_SH110X *_display;
+  char *_cells = NULL;   ///< _cols * _rows characters, row-major
+  uint8_t *_dirty = NULL; ///< One bit per cell
+  uint8_t _cols = 0, _rows = 0, _width = 0;
+  uint8_t _cursor_col = 0, _cursor_row = 0;
+  bool _cp437 = false;
+  bool _margin_dirty = false; ///< Columns right of the grid need clearing
+};
+
+#endif // _Adafruit_SH110X_TextGrid_H_
@@ -0,0 +1,428 @@
+/*!
+ * @file Adafruit_SH110X_TileMap.cpp
+ *
+ */
+
+#include "Adafruit_SH110X_TileMap.h"
+
+/*!
+    @brief  Constructor for a tile map layer.
+    @param  display
+            Pointer to the SH110X display whose framebuffer is composed
+            into. Its begin() must have been called first.
+    @param  tileset
+            PROGMEM array of num_tiles tiles, 8 bytes each. Each byte is one
+            column of the tile, LSB at the top, same as the framebuffer.
+    @param  num_tiles
+            Number of tiles in the tileset.
+*/
+Adafruit_SH110X_TileMap::Adafruit_SH110X_TileMap(Adafruit_SH110X *display,
+                                                 const uint8_t *tileset,
+                                                 uint16_t num_tiles)
+    : _display(display), _tileset(tileset), _num_tiles(num_tiles) {}
+
+/*!
+    @brief  Destructor for Adafruit_SH110X_TileMap object.
+*/
+Adafruit_SH110X_TileMap::~Adafruit_SH110X_TileMap(void) {
+  free(_map);
+  free(_changed);
+  free(_dirty);
+  free(_sprites);
+  _map = _changed = _dirty = NULL;
+  _sprites = NULL;
+}
+
+/*!
+    @brief  Allocate the tile map, dirty bits and sprite slots, and fill
+            the map with tile 0.
+    @param  max_sprites
+            Number of sprite slots (each costs sizeof(Adafruit_SH110X_Sprite)
+            bytes, mostly the 48-byte save-under).
+    @return true on successful allocation, false otherwise.
+*/
+bool Adafruit_SH110X_TileMap::begin(uint8_t max_sprites) {
+  if (!_display->getBuffer()) {
+    return false;
+  }
+
+  // native (rotation 0) geometry, regardless of current GFX rotation
+  bool swap = _display->getRotation() & 1;
+  uint8_t tw =
+      (swap ? _display->height() : _display->width()) / SH110X_TILE_SIZE;
+  uint8_t th =
+      (swap ? _display->width() : _display->height()) / SH110X_TILE_SIZE;
+
+  // allocate into locals so a failure leaves the object as it was
+  uint16_t tiles = (uint16_t)tw * th;
+  uint16_t bits = (tiles + 7) / 8;
+  uint8_t *map = _map ? _map : (uint8_t *)malloc(tiles);
+  uint8_t *changed = _changed ? _changed : (uint8_t *)malloc(bits);
+  uint8_t *dirty = _dirty ? _dirty : (uint8_t *)malloc(bits);
+  Adafruit_SH110X_Sprite *sprites = _sprites;
+  if (map && changed && dirty && max_sprites) {
+    sprites = (Adafruit_SH110X_Sprite *)realloc(
+        _sprites, max_sprites * sizeof(Adafruit_SH110X_Sprite));
+  }
+  if (!map || !changed || !dirty || (max_sprites && !sprites)) {
+    if (map != _map) {
+      free(map);
+    }
+    if (changed != _changed) {
+      free(changed);
+    }
+    if (dirty != _dirty) {
+      free(dirty);
+    }
+    return false; // realloc() left _sprites alone
+  }
+  if (!max_sprites) {
+    free(_sprites);
+    sprites = NULL;
+  }
+
+  _map = map;
+  _changed = changed;
+  _dirty = dirty;
+  _sprites = sprites;
+  _max_sprites = max_sprites;
+  _tw = tw;
+  _th = th;
+  if (_sprites) {
+    memset(_sprites, 0, max_sprites * sizeof(Adafruit_SH110X_Sprite));
+  }
+  memset(_dirty, 0, bits);
+
+  fill(0);
+  return true;
+}
+
+/*!
+    @brief  Set one map cell. Only marks it for re-rendering if the index
+            actually changes.
+    @param  tx
+            Tile column.
+    @param  ty
+            Tile row (page).
+    @param  tile
+            Index into the tileset.
+*/
+void Adafruit_SH110X_TileMap::setTile(uint8_t tx, uint8_t ty, uint8_t tile) {
+  if ((tx >= _tw) || (ty >= _th) || (tile >= _num_tiles)) {
+    return;
+  }
+  uint16_t i = (uint16_t)ty * _tw + tx;
+  if (_map[i] != tile) {
+    _map[i] = tile;
+    _changed[i / 8] |= (1 << (i & 7));
+  }
+}
+
+/*!
+    @brief  Read one map cell.
+    @param  tx
+            Tile column.
+    @param  ty
+            Tile row (page).
+    @return Tile index, or 0 if out of range.
+*/
+uint8_t Adafruit_SH110X_TileMap::getTile(uint8_t tx, uint8_t ty) const {
+  if ((tx >= _tw) || (ty >= _th)) {
+    return 0;
+  }
+  return _map[(uint16_t)ty * _tw + tx];
+}
+
+/*!
+    @brief  Set every map cell to the same tile and mark all for redraw.
+    @param  tile
+            Index into the tileset.
+*/
+void Adafruit_SH110X_TileMap::fill(uint8_t tile) {
+  uint16_t tiles = (uint16_t)_tw * _th;
+  memset(_map, (tile < _num_tiles) ? tile : 0, tiles);
+  memset(_changed, 0xFF, (tiles + 7) / 8);
+}
+
+/*!
+    @brief  Assign an image to a sprite slot.
+    @param  id
+            Sprite slot, 0 to max_sprites-1. Higher slots draw on top.
+    @param  bitmap
+            PROGMEM image in page format: (h + 7) / 8 rows of w column
+            bytes, LSB at the top. Pass NULL to free the slot.
+    @param  mask
+            PROGMEM opacity mask in the same format (1 = opaque), or NULL
+            to draw only the set pixels of bitmap.
+    @param  w
+            Width in pixels, up to SH110X_SPRITE_MAX_WIDTH.
+    @param  h
+            Height in pixels, up to SH110X_SPRITE_MAX_HEIGHT.
+    @return true on success, false if the slot does not exist or the image
+            is larger than the save-under holds; the slot is unchanged.
+*/
+bool Adafruit_SH110X_TileMap::setSprite(uint8_t id, const uint8_t *bitmap,
+                                        const uint8_t *mask, uint8_t w,
+                                        uint8_t h) {
+  if ((id >= _max_sprites) || (w > SH110X_SPRITE_MAX_WIDTH) ||
+      (h > SH110X_SPRITE_MAX_HEIGHT)) {
+    return false;
+  }
+  Adafruit_SH110X_Sprite *s = &_sprites[id];
+  s->bitmap = bitmap;
+  s->mask = mask;
+  s->w = w;
+  s->h = h;
+  s->visible = (bitmap != NULL);
+  s->changed = true;
+  return true;
+}
+
+/*!
+    @brief  Move a sprite (and show it if it was hidden).
+    @param  id
+            Sprite slot.
+    @param  x
+            New left edge, may be partly off screen.
+    @param  y
+            New top edge, may be partly off screen.
+*/
+void Adafruit_SH110X_TileMap::moveSprite(uint8_t id, int16_t x, int16_t y) {
+  if ((id >= _max_sprites) || !_sprites[id].bitmap) {
+    return;
+  }
+  Adafruit_SH110X_Sprite *s = &_sprites[id];
+  if ((s->x != x) || (s->y != y) || !s->visible) {
+    s->x = x;
+    s->y = y;
+    s->visible = true;
+    s->changed = true;
+  }
+}
+
+/*!
+    @brief  Hide a sprite; the background under it is restored on the next
+            update().
+    @param  id
+            Sprite slot.
+*/
+void Adafruit_SH110X_TileMap::hideSprite(uint8_t id) {
+  if ((id < _max_sprites) && _sprites[id].visible) {
+    _sprites[id].visible = false;
+    _sprites[id].changed = true;
+  }
+}
+
+/*!
+    @brief  Mark every tile for re-rendering and sending, e.g. after
+            clearDisplay() or other drawing into the framebuffer.
+*/
+void Adafruit_SH110X_TileMap::invalidate(void) {
+  memset(_changed, 0xFF, ((uint16_t)_tw * _th + 7) / 8);
+  for (uint8_t i = 0; i < _max_sprites; i++) {
+    _sprites[i].saved = false;
+    _sprites[i].changed = true;
+  }
+}
+
+/*!
+    @brief  Compose one frame and send only the tiles that changed: sprites
+            are lifted off (save-under restored), changed map tiles are
+            re-rendered, sprites are drawn back on, and every dirty tile is
+            flushed as runs of whole 8-column page segments.
+    @return true on success, false if a bus write failed.
+*/
+bool Adafruit_SH110X_TileMap::update(void) {
+  uint8_t *buffer = _display->getBuffer();
+  uint16_t width = (uint16_t)_tw * SH110X_TILE_SIZE;
+
+  // lift sprites off, topmost first, so each restores what it covered
+  for (uint8_t i = _max_sprites; i-- > 0;) {
+    _restoreSprite(&_sprites[i]);
+  }
+
+  // re-render map tiles that changed
+  for (uint8_t ty = 0; ty < _th; ty++) {
+    for (uint8_t tx = 0; tx < _tw; tx++) {
+      uint16_t i = (uint16_t)ty * _tw + tx;
+      if (!(_changed[i / 8] & (1 << (i & 7)))) {
+        continue;
+      }
+      const uint8_t *src = _tileset + (uint16_t)_map[i] * SH110X_TILE_SIZE;
+      uint8_t *dst = buffer + ty * width + tx * SH110X_TILE_SIZE;
+      for (uint8_t c = 0; c < SH110X_TILE_SIZE; c++) {
+        dst[c] = pgm_read_byte(src + c);
+      }
+      _dirty[i / 8] |= (1 << (i & 7));
+    }
+  }
+  memset(_changed, 0, ((uint16_t)_tw * _th + 7) / 8);
+
+  // put sprites back on, bottom first
+  for (uint8_t i = 0; i < _max_sprites; i++) {
+    _drawSprite(&_sprites[i]);
+  }
+
+  // one bus session for the frame, not one per run of tiles
+  _display->beginSession();
+  bool ok = _flush();
+  _display->endSession();
+  return ok;
+}
+
+/*!
+    @brief  Mark the tiles covering a pixel-column/page rectangle dirty.
+    @param  x
+            First column.
+    @param  page
+            First page.
+    @param  w
+            Number of columns.
+    @param  pages
+            Number of pages.
+*/
+void Adafruit_SH110X_TileMap::_markDirty(int16_t x, int16_t page, int16_t w,
+                                         int16_t pages) {
+  for (int16_t ty = page; ty < page + pages; ty++) {
+    for (int16_t tx = x / SH110X_TILE_SIZE;
+         tx <= (x + w - 1) / SH110X_TILE_SIZE; tx++) {
+      uint16_t i = (uint16_t)ty * _tw + tx;
+      _dirty[i / 8] |= (1 << (i & 7));
+    }
+  }
+}
+
+/*!
+    @brief  Put back the framebuffer bytes a sprite was drawn over.
+    @param  s
+            Sprite to lift off.
+*/
+void Adafruit_SH110X_TileMap::_restoreSprite(Adafruit_SH110X_Sprite *s) {
+  if (!s->saved) {
+    return;
+  }
+  uint8_t *buffer = _display->getBuffer();
+  uint16_t width = (uint16_t)_tw * SH110X_TILE_SIZE;
+  const uint8_t *src = s->save;
+
+  for (uint8_t p = 0; p < s->save_pages; p++) {
+    memcpy(buffer + (s->save_page + p) * width + s->save_x, src, s->save_w);
+    src += s->save_w;
+  }
+  if (s->changed) {
+    _markDirty(s->save_x, s->save_page, s->save_w, s->save_pages);
+  }
+  s->saved = false;
+}
+
+/*!
+    @brief  Save the bytes under a sprite, then compose it into the
+            framebuffer, clipped to the screen.
+    @param  s
+            Sprite to draw.
+*/
+void Adafruit_SH110X_TileMap::_drawSprite(Adafruit_SH110X_Sprite *s) {
+  if (!s->visible || !s->bitmap) {
+    s->changed = false;
+    return;
+  }
+
+  uint8_t *buffer = _display->getBuffer();
+  int16_t width = (int16_t)_tw * SH110X_TILE_SIZE;
+
+  // page containing the top edge (floor for negative y) and bit shift
+  int16_t page0 = (s->y >= 0) ? (s->y / 8) : -((7 - s->y) / 8);
+  uint8_t shift = s->y - page0 * 8;
+  int16_t pages = (shift + s->h + 7) / 8;
+
+  int16_t x0 = max(s->x, (int16_t)0);
+  int16_t x1 = min((int16_t)(s->x + s->w), width);
+  int16_t p0 = max(page0, (int16_t)0);
+  int16_t p1 = min((int16_t)(page0 + pages), (int16_t)_th);
+  if ((x0 >= x1) || (p0 >= p1)) {
+    s->changed = false;
+    return;
+  }
+
+  // save-under
+  s->save_x = x0;
+  s->save_w = x1 - x0;
+  s->save_page = p0;
+  s->save_pages = p1 - p0;
+  uint8_t *dst = s->save;
+  for (int16_t p = p0; p < p1; p++) {
+    memcpy(dst, buffer + p * width + x0, s->save_w);
+    dst += s->save_w;
+  }
+  s->saved = true;
+
+  // compose column by column, spreading each source column over pages
+  uint32_t hmask = ((uint32_t)1 << s->h) - 1;
+  uint8_t src_pages = (s->h + 7) / 8;
+  for (int16_t x = x0; x < x1; x++) {
+    uint8_t c = x - s->x;
+    uint32_t bits = 0, mask = 0;
+    for (uint8_t sp = 0; sp < src_pages; sp++) {
+      bits |= (uint32_t)pgm_read_byte(s->bitmap + sp * s->w + c) << (sp * 8);
+      if (s->mask) {
+        mask |= (uint32_t)pgm_read_byte(s->mask + sp * s->w + c) << (sp * 8);
+      }
+    }
+    bits &= hmask;
+    mask = s->mask ? (mask & hmask) : bits;
+    bits <<= shift;
+    mask <<= shift;
+
+    for (int16_t p = p0; p < p1; p++) {
+      uint8_t k = (p - page0) * 8;
+      uint8_t m = mask >> k;
+      uint8_t *b = buffer + p * width + x;
+      *b = (*b & ~m) | ((uint8_t)(bits >> k) & m);
+    }
+  }
+
+  if (s->changed) {
+    _markDirty(s->save_x, s->save_page, s->save_w, s->save_pages);
+    s->changed = false;
+  }
+}
+
+/*!
+    @brief  Send every dirty tile, coalescing horizontal runs into one
+            write per run, then clear the dirty bits, inside a session
+            opened by update().
+    @return true on success, false if a bus write failed.
+*/
+bool Adafruit_SH110X_TileMap::_flush(void) {
+  uint8_t *buffer = _display->getBuffer();
+  uint16_t width = (uint16_t)_tw * SH110X_TILE_SIZE;
+
+  for (uint8_t ty = 0; ty < _th; ty++) {
+    uint8_t tx = 0;
+    while (tx < _tw) {
+      uint16_t i = (uint16_t)ty * _tw + tx;
+      if (!(_dirty[i / 8] & (1 << (i & 7)))) {
+        tx++;
+        continue;
+      }
+      uint8_t first = tx;
+      while (tx < _tw) {
+        i = (uint16_t)ty * _tw + tx;
+        if (!(_dirty[i / 8] & (1 << (i & 7)))) {
+          break;
+        }
+        tx++;
+      }
+      uint8_t col = first * SH110X_TILE_SIZE;
+      if (!_display->writeDisplayData(ty, col, buffer + ty * width + col,
+                                      (tx - first) * SH110X_TILE_SIZE)) {
+        return false; // the failed run stays dirty
+      }
+      for (uint8_t t = first; t < tx; t++) {
+        i = (uint16_t)ty * _tw + t;
+        _dirty[i / 8] &= ~(1 << (i & 7));
+      }
+    }
+  }
+  return true;
+}
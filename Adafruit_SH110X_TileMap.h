@@ -0,0 +1,97 @@
+/*!
+ * @file Adafruit_SH110X_TileMap.h
+ *
+ * Tile-map and software sprite layer for SH110X displays. Tiles are 8x8,
+ * exactly one page high, and per-tile dirty bits drive partial flushes so
+ * only tiles touched by changed tiles or moving sprites go on the bus.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#ifndef _Adafruit_SH110X_TileMap_H_
+#define _Adafruit_SH110X_TileMap_H_
+
+#include "Adafruit_SH110X.h"
+
+#define SH110X_TILE_SIZE 8           ///< Tile width and height in pixels
+#define SH110X_SPRITE_MAX_WIDTH 16   ///< Widest sprite supported
+#define SH110X_SPRITE_MAX_HEIGHT 16  ///< Tallest sprite supported
+#define SH110X_SPRITE_SAVE_BYTES 48  ///< Save-under: 16 columns x 3 pages
+
+/*!
+    @brief  State for one software sprite, including the framebuffer bytes
+            it covers (save-under) so it can be erased without redrawing.
+*/
+typedef struct {
+  const uint8_t *bitmap; ///< PROGMEM image, page format (see setSprite())
+  const uint8_t *mask;   ///< PROGMEM opacity mask, same format, or NULL
+  int16_t x;             ///< Left edge in native display coordinates
+  int16_t y;             ///< Top edge in native display coordinates
+  uint8_t w;             ///< Width in pixels
+  uint8_t h;             ///< Height in pixels
+  bool visible;          ///< Drawn on the next update()
+  bool changed;          ///< Moved, hidden or re-imaged since last update()
+  bool saved;            ///< save[] holds the bytes currently under it
+  uint8_t save_x;        ///< First saved column
+  uint8_t save_w;        ///< Number of saved columns
+  uint8_t save_page;     ///< First saved page
+  uint8_t save_pages;    ///< Number of saved pages
+  uint8_t save[SH110X_SPRITE_SAVE_BYTES]; ///< Saved framebuffer bytes
+} Adafruit_SH110X_Sprite;
+
+/*!
+    @brief  Byte-indexed map of 8x8 tiles composed into the display's
+            framebuffer, with sprites on top. Works in the display's native
+            (unrotated) orientation so a tile row is one page.
+*/
+class Adafruit_SH110X_TileMap {
+public:
+  Adafruit_SH110X_TileMap(Adafruit_SH110X *display, const uint8_t *tileset,
+                          uint16_t num_tiles);
+  ~Adafruit_SH110X_TileMap(void);
+
+  bool begin(uint8_t max_sprites = 4);
+
+  void setTile(uint8_t tx, uint8_t ty, uint8_t tile);
+  uint8_t getTile(uint8_t tx, uint8_t ty) const;
+  void fill(uint8_t tile);
+
+  bool setSprite(uint8_t id, const uint8_t *bitmap, const uint8_t *mask,
+                 uint8_t w, uint8_t h);
+  void moveSprite(uint8_t id, int16_t x, int16_t y);
+  void hideSprite(uint8_t id);
+
+  void invalidate(void);
+  bool update(void);
+
+  /*!
+    @brief  Width of the map in tiles.
+    @return Number of tile columns.
+  */
+  uint8_t tilesWide(void) const { return _tw; }
+
+  /*!
+    @brief  Height of the map in tiles (equal to the number of pages).
+    @return Number of tile rows.
+  */
+  uint8_t tilesHigh(void) const { return _th; }
+
+private:
+  void _markDirty(int16_t x, int16_t page, int16_t w, int16_t pages);
+  void _restoreSprite(Adafruit_SH110X_Sprite *s);
+  void _drawSprite(Adafruit_SH110X_Sprite *s);
+  bool _flush(void);
+
+  Adafruit_SH110X *_display;
+  const uint8_t *_tileset;
+  uint16_t _num_tiles;
+  uint8_t *_map = NULL;      ///< _tw * _th tile indices
+  uint8_t *_changed = NULL;  ///< Per-tile: re-render from the tileset
+  uint8_t *_dirty = NULL;    ///< Per-tile: needs sending to the display
+  Adafruit_SH110X_Sprite *_sprites = NULL;
+  uint8_t _max_sprites = 0;
+  uint8_t _tw = 0, _th = 0;
+};
+
+#endif // _Adafruit_SH110X_TileMap_H_
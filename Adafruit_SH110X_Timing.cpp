@@ -0,0 +1,177 @@
+/*!
+ * @file Adafruit_SH110X_Timing.cpp
+ *
+ */
+
+#include "Adafruit_SH110X_Timing.h"
+
+// transaction_us, byte_gap_ns, yield_us, set_speed_us, dc_toggle_ns
+const sh110x_mcu_profile_t SH110X_MCU_IDEAL = {0, 0, 0, 0, 0};
+const sh110x_mcu_profile_t SH110X_MCU_AVR = {25, 2000, 1, 5, 4000};
+const sh110x_mcu_profile_t SH110X_MCU_SAMD21 = {15, 1000, 1, 20, 1000};
+const sh110x_mcu_profile_t SH110X_MCU_RP2040 = {8, 300, 1, 10, 200};
+const sh110x_mcu_profile_t SH110X_MCU_ESP32 = {30, 200, 5, 30, 100};
+
+/*!
+    @brief  Constructor for a bus timing model.
+    @param  bus
+            SH110X_BUS_I2C or SH110X_BUS_SPI.
+    @param  clock
+            Bus clock in Hz (the 'during' clock for I2C).
+    @param  mcu
+            Software overheads to add, see sh110x_mcu_profile_t.
+    @param  downstream
+            Transport to pass every call on to, or NULL to only model.
+*/
+Adafruit_SH110X_TimingModel::Adafruit_SH110X_TimingModel(
+    sh110x_bus_t bus, uint32_t clock, const sh110x_mcu_profile_t *mcu,
+    Adafruit_SH110X_Transport *downstream)
+    : _bus(bus), _mcu(mcu), _downstream(downstream) {
+  _bit_ns = clock ? 1000000000UL / clock : 0;
+  reset();
+}
+
+/*!
+    @brief  Begin the downstream transport, if any.
+    @return true on success.
+*/
+bool Adafruit_SH110X_TimingModel::begin(void) {
+  return _downstream ? _downstream->begin() : true;
+}
+
+/*!
+    @brief  Start timing a frame. On I2C this includes switching the bus
+            to the session clock.
+*/
+void Adafruit_SH110X_TimingModel::beginSession(void) {
+  _in_session = true;
+  _frame_start_us = _total_us;
+  if (_bus == SH110X_BUS_I2C) {
+    _spend(_mcu->set_speed_us * 1000UL);
+  }
+  if (_downstream) {
+    _downstream->beginSession();
+  }
+}
+
+/*!
+    @brief  Finish timing a frame and update the frame statistics.
+*/
+void Adafruit_SH110X_TimingModel::endSession(void) {
+  if (_bus == SH110X_BUS_I2C) {
+    _spend(_mcu->set_speed_us * 1000UL);
+  }
+  if (_in_session) {
+    _last_frame_us = _total_us - _frame_start_us;
+    _max_frame_us = max(_max_frame_us, _last_frame_us);
+    _frame_sum_us += _last_frame_us;
+    _frames++;
+    _in_session = false;
+  }
+  if (_downstream) {
+    _downstream->endSession();
+  }
+}
+
+/*!
+    @brief  Account for a command write.
+    @param  cmds
+            Command bytes.
+    @param  len
+            Number of bytes.
+    @return Downstream result, or true if there is no downstream.
+*/
+bool Adafruit_SH110X_TimingModel::writeCommands(const uint8_t *cmds,
+                                                size_t len) {
+  _transfer(len);
+  return _downstream ? _downstream->writeCommands(cmds, len) : true;
+}
+
+/*!
+    @brief  Account for a data write.
+    @param  data
+            Display RAM bytes.
+    @param  len
+            Number of bytes.
+    @return Downstream result, or true if there is no downstream.
+*/
+bool Adafruit_SH110X_TimingModel::writeData(const uint8_t *data,
+                                            size_t len) {
+  _transfer(len);
+  return _downstream ? _downstream->writeData(data, len) : true;
+}
+
+/*!
+    @brief  Run a log made by Adafruit_SH110X_RecordingTransport through
+            the model (and on to the downstream transport).
+    @param  log
+            Log buffer.
+    @param  len
+            Valid length of the log.
+    @return true if the whole log was replayed, false if it is truncated
+            or a downstream write failed.
+*/
+bool Adafruit_SH110X_TimingModel::replay(const uint8_t *log, size_t len) {
+  return Adafruit_SH110X_RecordingTransport::replay(log, len, this);
+}
+
+/*!
+    @brief  Zero all times and counters.
+*/
+void Adafruit_SH110X_TimingModel::reset(void) {
+  _total_us = _carry_ns = 0;
+  _frame_start_us = _frame_sum_us = _last_frame_us = _max_frame_us = 0;
+  _frames = transactions = 0;
+  _in_session = false;
+}
+
+/*!
+    @brief  Frame rate the bus could sustain at the average frame time.
+    @return Frames per second, 0 if no frame has completed.
+*/
+float Adafruit_SH110X_TimingModel::framesPerSecond(void) const {
+  if (!_frames || !_frame_sum_us) {
+    return 0;
+  }
+  return (float)_frames * 1000000.0 / _frame_sum_us;
+}
+
+/*!
+    @brief  Add the time one write takes, split into transactions the way
+            the real transport would.
+    @param  len
+            Payload bytes.
+*/
+void Adafruit_SH110X_TimingModel::_transfer(size_t len) {
+  if (_bus == SH110X_BUS_SPI) {
+    // one transaction per write, no framing bits
+    transactions++;
+    _spend(_mcu->transaction_us * 1000UL + _mcu->dc_toggle_ns +
+           len * (8 * _bit_ns + _mcu->byte_gap_ns));
+    return;
+  }
+  if (!_in_session) {
+    // the transport raises the clock around a write outside a session
+    _spend(2 * _mcu->set_speed_us * 1000UL);
+  }
+  while (len) {
+    size_t n = min(len, (size_t)_chunk);
+    // start, address + ACK, control byte + ACK, payload, stop
+    uint32_t bits = 1 + 9 + 9 + 9 * n + 1;
+    transactions++;
+    _spend(_mcu->transaction_us * 1000UL + bits * _bit_ns +
+           (n + 1) * _mcu->byte_gap_ns + _mcu->yield_us * 1000UL);
+    len -= n;
+  }
+}
+
+/*!
+    @brief  Advance the modelled clock, keeping sub-microsecond remainders.
+    @param  ns
+            Nanoseconds to add.
+*/
+void Adafruit_SH110X_TimingModel::_spend(uint32_t ns) {
+  ns += _carry_ns;
+  _total_us += ns / 1000;
+  _carry_ns = ns % 1000;
+}
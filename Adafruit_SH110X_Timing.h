@@ -0,0 +1,119 @@
+/*!
+ * @file Adafruit_SH110X_Timing.h
+ *
+ * Bus timing model for SH110X traffic. It turns the writes the driver
+ * makes (live, or replayed from a recording) into estimated wall-clock
+ * time per frame, so panel size, bus and clock can be weighed before
+ * there is hardware to measure.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#ifndef _Adafruit_SH110X_Timing_H_
+#define _Adafruit_SH110X_Timing_H_
+
+#include "Adafruit_SH110X_Transport.h"
+
+/*!
+    @brief  Bus the modelled transport uses.
+*/
+typedef enum {
+  SH110X_BUS_I2C, ///< Control byte per transaction, 9 bits per byte
+  SH110X_BUS_SPI, ///< D/C pin per write, 8 bits per byte
+} sh110x_bus_t;
+
+/*!
+    @brief  Software costs of one MCU and its bus library, added on top of
+            the time the bits spend on the wire. The bundled profiles are
+            rough figures for the stock Arduino cores; measure with a logic
+            analyzer and make your own for anything that matters.
+*/
+typedef struct {
+  uint16_t transaction_us; ///< Per transaction: begin/end, CS, ISR setup
+  uint16_t byte_gap_ns;    ///< Idle bus time between bytes while CPU works
+  uint16_t yield_us;       ///< Each yield() between I2C chunks
+  uint16_t set_speed_us;   ///< Each I2C clock change (see I2CTransport)
+  uint16_t dc_toggle_ns;   ///< Each D/C pin write (SPI only)
+} sh110x_mcu_profile_t;
+
+extern const sh110x_mcu_profile_t SH110X_MCU_IDEAL;  ///< Wire time only
+extern const sh110x_mcu_profile_t SH110X_MCU_AVR;    ///< 16 MHz ATmega328
+extern const sh110x_mcu_profile_t SH110X_MCU_SAMD21; ///< 48 MHz Cortex-M0+
+extern const sh110x_mcu_profile_t SH110X_MCU_RP2040; ///< 125 MHz Cortex-M0+
+extern const sh110x_mcu_profile_t SH110X_MCU_ESP32;  ///< 240 MHz Xtensa
+
+/*!
+    @brief  Transport that estimates how long its traffic would take. Use
+            it in place of (or in front of) a real transport, or feed it a
+            log from Adafruit_SH110X_RecordingTransport with replay(). Each
+            session counts as one frame.
+*/
+class Adafruit_SH110X_TimingModel : public Adafruit_SH110X_Transport {
+public:
+  Adafruit_SH110X_TimingModel(sh110x_bus_t bus, uint32_t clock,
+                              const sh110x_mcu_profile_t *mcu =
+                                  &SH110X_MCU_IDEAL,
+                              Adafruit_SH110X_Transport *downstream = NULL);
+
+  bool begin(void);
+  void beginSession(void);
+  void endSession(void);
+  bool writeCommands(const uint8_t *cmds, size_t len);
+  bool writeData(const uint8_t *data, size_t len);
+
+  bool replay(const uint8_t *log, size_t len);
+  void reset(void);
+  float framesPerSecond(void) const;
+
+  /*!
+    @brief  Set how many payload bytes fit in one I2C transaction; the
+            I2C transport uses the device's maxBufferSize() minus one.
+    @param  bytes
+            Payload bytes per transaction, at least 1.
+  */
+  void setChunkSize(uint16_t bytes) { _chunk = bytes ? bytes : 1; }
+
+  /*!
+    @brief  Modelled time of everything since reset().
+    @return Microseconds.
+  */
+  uint32_t totalMicros(void) const { return _total_us; }
+
+  /*!
+    @brief  Modelled time of the most recent complete frame.
+    @return Microseconds.
+  */
+  uint32_t lastFrameMicros(void) const { return _last_frame_us; }
+
+  /*!
+    @brief  Modelled time of the slowest frame since reset().
+    @return Microseconds.
+  */
+  uint32_t maxFrameMicros(void) const { return _max_frame_us; }
+
+  /*!
+    @brief  Complete frames (sessions) since reset().
+    @return Frame count.
+  */
+  uint32_t frames(void) const { return _frames; }
+
+  uint32_t transactions; ///< Bus transactions since reset()
+
+private:
+  void _transfer(size_t len);
+  void _spend(uint32_t ns);
+
+  sh110x_bus_t _bus;
+  uint32_t _bit_ns;
+  const sh110x_mcu_profile_t *_mcu;
+  Adafruit_SH110X_Transport *_downstream;
+  uint16_t _chunk = 31;
+
+  uint32_t _total_us, _carry_ns;
+  uint32_t _frame_start_us, _frame_sum_us, _last_frame_us, _max_frame_us;
+  uint32_t _frames;
+  bool _in_session;
+};
+
+#endif // _Adafruit_SH110X_Timing_H_
@@ -0,0 +1,109 @@
+/*!
+ * @file Adafruit_SH110X_Trace.cpp
+ *
+ */
+
+#include "Adafruit_SH110X_Trace.h"
+
+#ifdef SH110X_ENABLE_TRACE
+
+sh110x_trace_event_t Adafruit_SH110X_Trace::_ring[SH110X_TRACE_SIZE];
+uint16_t Adafruit_SH110X_Trace::_head = 0;
+uint16_t Adafruit_SH110X_Trace::_count = 0;
+
+static const char name_flush[] PROGMEM = "flush";
+static const char name_page[] PROGMEM = "page";
+static const char name_chunk[] PROGMEM = "chunk";
+static const char name_yield[] PROGMEM = "yield";
+static const char name_overlap[] PROGMEM = "draw during flush";
+static const char *const names[] PROGMEM = {
+    name_flush, name_page, name_chunk, name_yield, name_overlap};
+
+/*!
+    @brief  Append an event, overwriting the oldest once the ring is full.
+    @param  event
+            SH110X_TRACE_ id, ORed with SH110X_TRACE_END to close a span.
+    @param  arg
+            Event argument (page number, byte count...).
+*/
+void Adafruit_SH110X_Trace::record(uint8_t event, uint8_t arg) {
+  sh110x_trace_event_t *e = &_ring[_head];
+  e->micros = micros();
+  e->event = event;
+  e->arg = arg;
+  _head = (_head + 1) % SH110X_TRACE_SIZE;
+  if (_count < SH110X_TRACE_SIZE) {
+    _count++;
+  }
+}
+
+/*!
+    @brief  Drop all recorded events.
+*/
+void Adafruit_SH110X_Trace::clear(void) { _head = _count = 0; }
+
+/*!
+    @brief  Number of events held.
+    @return Event count, at most SH110X_TRACE_SIZE.
+*/
+uint16_t Adafruit_SH110X_Trace::count(void) { return _count; }
+
+/*!
+    @brief  Read an event, oldest first.
+    @param  index
+            0 for the oldest event held, count()-1 for the newest.
+    @param  event
+            Where to copy the event.
+    @return true if index was in range.
+*/
+bool Adafruit_SH110X_Trace::get(uint16_t index, sh110x_trace_event_t *event) {
+  if (index >= _count) {
+    return false;
+  }
+  uint16_t first = (_head + SH110X_TRACE_SIZE - _count) % SH110X_TRACE_SIZE;
+  *event = _ring[(first + index) % SH110X_TRACE_SIZE];
+  return true;
+}
+
+/*!
+    @brief  Print the events as Chrome trace JSON, for chrome://tracing or
+            ui.perfetto.dev. Spans become B/E pairs, the rest instants.
+    @param  out
+            Where to print, e.g. &Serial. Capture the output to a .json
+            file and open it in the viewer.
+    @note   If the ring wrapped, the oldest span may show an end without
+            its begin; the viewers ignore those.
+*/
+void Adafruit_SH110X_Trace::printChromeTrace(Print *out) {
+  sh110x_trace_event_t e;
+  bool first = true;
+  out->print(F("{\"traceEvents\":["));
+  for (uint16_t i = 0; get(i, &e); i++) {
+    uint8_t id = e.event & ~SH110X_TRACE_END;
+    bool span = (id == SH110X_TRACE_FLUSH) || (id == SH110X_TRACE_PAGE) ||
+                (id == SH110X_TRACE_CHUNK);
+    if (id > SH110X_TRACE_OVERLAP) {
+      continue;
+    }
+    if (!first) {
+      out->print(',');
+    }
+    first = false;
+    out->print(F("\n{\"name\":\""));
+    out->print((const __FlashStringHelper *)pgm_read_ptr(&names[id]));
+    out->print(F("\",\"ph\":\""));
+    out->print(span ? ((e.event & SH110X_TRACE_END) ? 'E' : 'B') : 'i');
+    out->print(F("\",\"ts\":"));
+    out->print(e.micros);
+    out->print(F(",\"pid\":1,\"tid\":1"));
+    if (!(e.event & SH110X_TRACE_END) && (id != SH110X_TRACE_FLUSH)) {
+      out->print(F(",\"args\":{\"arg\":"));
+      out->print(e.arg);
+      out->print('}');
+    }
+    out->print('}');
+  }
+  out->println(F("\n]}"));
+}
+
+#endif // SH110X_ENABLE_TRACE
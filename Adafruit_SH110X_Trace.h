@@ -0,0 +1,69 @@
+/*!
+ * @file Adafruit_SH110X_Trace.h
+ *
+ * Optional event tracing for SH110X flushes. When enabled, the driver and
+ * its transports log timestamped events (flush, page, bus chunk, yield,
+ * drawing during a flush) into a small ring buffer that can be dumped as
+ * a Chrome trace / Perfetto JSON timeline. When disabled the hooks compile
+ * to nothing.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#ifndef _Adafruit_SH110X_Trace_H_
+#define _Adafruit_SH110X_Trace_H_
+
+#include <Arduino.h>
+
+// Uncomment to record flush events, see Adafruit_SH110X_Trace
+//#define SH110X_ENABLE_TRACE
+
+#ifndef SH110X_TRACE_SIZE
+#define SH110X_TRACE_SIZE 64 ///< Events kept in the ring buffer
+#endif
+
+#define SH110X_TRACE_FLUSH 0   ///< display() span
+#define SH110X_TRACE_PAGE 1    ///< One page run addressed and sent, arg = page
+#define SH110X_TRACE_CHUNK 2   ///< One bus transaction, arg = bytes
+#define SH110X_TRACE_YIELD 3   ///< yield() call, instant
+#define SH110X_TRACE_OVERLAP 4 ///< drawPixel() while a flush runs, instant
+#define SH110X_TRACE_END 0x80  ///< Flag on the event that closes a span
+
+#ifdef SH110X_ENABLE_TRACE
+/// Log an event into the trace ring
+#define SH110X_TRACE(event, arg) Adafruit_SH110X_Trace::record(event, arg)
+#else
+/// Tracing disabled, compiles to nothing
+#define SH110X_TRACE(event, arg)
+#endif
+
+/*!
+    @brief  One traced event.
+*/
+typedef struct {
+  uint32_t micros; ///< micros() when it happened
+  uint8_t event;   ///< SH110X_TRACE_ id, ORed with SH110X_TRACE_END
+  uint8_t arg;     ///< Event argument, see the ids
+} sh110x_trace_event_t;
+
+/*!
+    @brief  Global ring buffer of trace events. All displays share it, so
+            the events of several panels interleave on one timeline.
+    @note   Not interrupt safe: events recorded from an ISR while the main
+            loop records one may be lost.
+*/
+class Adafruit_SH110X_Trace {
+public:
+  static void record(uint8_t event, uint8_t arg);
+  static void clear(void);
+  static uint16_t count(void);
+  static bool get(uint16_t index, sh110x_trace_event_t *event);
+  static void printChromeTrace(Print *out);
+
+private:
+  static sh110x_trace_event_t _ring[SH110X_TRACE_SIZE];
+  static uint16_t _head, _count;
+};
+
+#endif // _Adafruit_SH110X_Trace_H_
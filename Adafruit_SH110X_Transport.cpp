@@ -0,0 +1,449 @@
+/*!
+ * @file Adafruit_SH110X_Transport.cpp
+ *
+ */
+
+#include "Adafruit_SH110X_Transport.h"
+
+// I2C ---------------------------------------------------------------------
+
+/*!
+    @brief  Constructor for the I2C transport.
+    @param  dev
+            I2C device for the display, already created with its address.
+    @param  clkDuring
+            Bus clock (Hz) to use during a session.
+    @param  clkAfter
+            Bus clock (Hz) to restore when the session ends.
+*/
+Adafruit_SH110X_I2CTransport::Adafruit_SH110X_I2CTransport(
+    Adafruit_I2CDevice *dev, uint32_t clkDuring, uint32_t clkAfter)
+    : _dev(dev), _clk_during(clkDuring), _clk_after(clkAfter) {}
+
+/*!
+    @brief  Check the device was created.
+    @return true if there is a device to talk to.
+*/
+bool Adafruit_SH110X_I2CTransport::begin(void) { return _dev != NULL; }
+
+/*!
+    @brief  Switch the bus to the fast clock for a frame.
+*/
+void Adafruit_SH110X_I2CTransport::beginSession(void) {
+  _dev->setSpeed(_clk_during);
+  _in_session = true;
+}
+
+/*!
+    @brief  Return the bus to the slower clock other devices expect.
+*/
+void Adafruit_SH110X_I2CTransport::endSession(void) {
+  _dev->setSpeed(_clk_after);
+  _in_session = false;
+}
+
+/*!
+    @brief  Send command bytes with the 0x00 control byte (Co = 0, D/C = 0).
+    @param  cmds
+            Command bytes.
+    @param  len
+            Number of bytes.
+    @return true on success, false on a bus error.
+*/
+bool Adafruit_SH110X_I2CTransport::writeCommands(const uint8_t *cmds,
+                                                 size_t len) {
+  return _write(0x00, cmds, len);
+}
+
+/*!
+    @brief  Send display data with the 0x40 control byte (Co = 0, D/C = 1).
+    @param  data
+            Display RAM bytes.
+    @param  len
+            Number of bytes.
+    @return true on success, false on a bus error.
+*/
+bool Adafruit_SH110X_I2CTransport::writeData(const uint8_t *data,
+                                             size_t len) {
+  return _write(0x40, data, len);
+}
+
+/*!
+    @brief  Split a write into transactions that fit the device buffer,
+            each starting with the control byte. Outside a session the
+            clock is raised for just this write, as the stock GrayOLED
+            command functions do.
+    @param  control
+            SH110X control byte.
+    @param  buf
+            Bytes to send.
+    @param  len
+            Number of bytes.
+    @return true on success, false on a bus error.
+*/
+bool Adafruit_SH110X_I2CTransport::_write(uint8_t control, const uint8_t *buf,
+                                          size_t len) {
+  size_t maxbuff = _dev->maxBufferSize() - 1;
+  bool own_clock = !_in_session;
+  bool ok = true;
+
+  if (own_clock) {
+    _dev->setSpeed(_clk_during);
+  }
+  while (len) {
+    size_t to_write = min(len, maxbuff);
+    SH110X_TRACE(SH110X_TRACE_CHUNK, to_write);
+    if (!_dev->write(buf, to_write, true, &control, 1)) {
+      ok = false;
+      break;
+    }
+    SH110X_TRACE(SH110X_TRACE_CHUNK | SH110X_TRACE_END, 0);
+    buf += to_write;
+    len -= to_write;
+    // ESP8266 needs a periodic yield() call to avoid watchdog reset.
+    SH110X_TRACE(SH110X_TRACE_YIELD, 0);
+    yield();
+  }
+  if (own_clock) {
+    _dev->setSpeed(_clk_after);
+  }
+  return ok;
+}
+
+// SPI ---------------------------------------------------------------------
+
+/*!
+    @brief  Constructor for the SPI transport.
+    @param  dev
+            SPI device for the display (hardware or bitbang).
+    @param  dc_pin
+            Data/command pin (using Arduino pin numbering).
+*/
+Adafruit_SH110X_SPITransport::Adafruit_SH110X_SPITransport(
+    Adafruit_SPIDevice *dev, int16_t dc_pin)
+    : _dev(dev), _dc_pin(dc_pin) {}
+
+/*!
+    @brief  Check the device was created.
+    @return true if there is a device to talk to.
+*/
+bool Adafruit_SH110X_SPITransport::begin(void) { return _dev != NULL; }
+
+/*!
+    @brief  Send command bytes with D/C low.
+    @param  cmds
+            Command bytes.
+    @param  len
+            Number of bytes.
+    @return true on success, false on a bus error.
+*/
+bool Adafruit_SH110X_SPITransport::writeCommands(const uint8_t *cmds,
+                                                 size_t len) {
+  digitalWrite(_dc_pin, LOW);
+  SH110X_TRACE(SH110X_TRACE_CHUNK, min(len, (size_t)255));
+  bool ok = _dev->write(cmds, len);
+  SH110X_TRACE(SH110X_TRACE_CHUNK | SH110X_TRACE_END, 0);
+  return ok;
+}
+
+/*!
+    @brief  Send display data with D/C high.
+    @param  data
+            Display RAM bytes.
+    @param  len
+            Number of bytes.
+    @return true on success, false on a bus error.
+*/
+bool Adafruit_SH110X_SPITransport::writeData(const uint8_t *data,
+                                             size_t len) {
+  digitalWrite(_dc_pin, HIGH);
+  SH110X_TRACE(SH110X_TRACE_CHUNK, min(len, (size_t)255));
+  bool ok = _dev->write(data, len);
+  SH110X_TRACE(SH110X_TRACE_CHUNK | SH110X_TRACE_END, 0);
+  return ok;
+}
+
+// RECORDING ---------------------------------------------------------------
+
+/*!
+    @brief  Constructor for the recording test double.
+    @param  downstream
+            Transport to pass every call on to, or NULL to only record.
+    @param  log
+            Buffer to append records to, or NULL to only count.
+    @param  log_size
+            Size of the log buffer in bytes.
+    @param  ring
+            If true, overwrite the oldest records when the log is full
+            instead of stopping, to keep the traffic leading up to an
+            event of interest.
+*/
+Adafruit_SH110X_RecordingTransport::Adafruit_SH110X_RecordingTransport(
+    Adafruit_SH110X_Transport *downstream, uint8_t *log, size_t log_size,
+    bool ring)
+    : _downstream(downstream), _log(log), _log_size(log_size), _ring(ring) {
+  reset();
+}
+
+/*!
+    @brief  Begin the downstream transport, if any.
+    @return true on success.
+*/
+bool Adafruit_SH110X_RecordingTransport::begin(void) {
+  return _downstream ? _downstream->begin() : true;
+}
+
+/*!
+    @brief  Record and forward a session start.
+*/
+void Adafruit_SH110X_RecordingTransport::beginSession(void) {
+  sessions++;
+  _record(SH110X_REC_BEGIN, NULL, 0);
+  if (_downstream) {
+    _downstream->beginSession();
+  }
+}
+
+/*!
+    @brief  Record and forward a session end.
+*/
+void Adafruit_SH110X_RecordingTransport::endSession(void) {
+  _record(SH110X_REC_END, NULL, 0);
+  if (_downstream) {
+    _downstream->endSession();
+  }
+}
+
+/*!
+    @brief  Record and forward command bytes.
+    @param  cmds
+            Command bytes.
+    @param  len
+            Number of bytes.
+    @return Downstream result, or true if there is no downstream.
+*/
+bool Adafruit_SH110X_RecordingTransport::writeCommands(const uint8_t *cmds,
+                                                       size_t len) {
+  commandBytes += len;
+  writes++;
+  _record(SH110X_REC_COMMANDS, cmds, len);
+  return _downstream ? _downstream->writeCommands(cmds, len) : true;
+}
+
+/*!
+    @brief  Record and forward display data.
+    @param  data
+            Display RAM bytes.
+    @param  len
+            Number of bytes.
+    @return Downstream result, or true if there is no downstream.
+*/
+bool Adafruit_SH110X_RecordingTransport::writeData(const uint8_t *data,
+                                                   size_t len) {
+  dataBytes += len;
+  writes++;
+  _record(SH110X_REC_DATA, data, len);
+  return _downstream ? _downstream->writeData(data, len) : true;
+}
+
+/*!
+    @brief  Zero the counters and empty the log.
+*/
+void Adafruit_SH110X_RecordingTransport::reset(void) {
+  commandBytes = dataBytes = writes = sessions = 0;
+  _log_len = _start = 0;
+  _overflow = false;
+}
+
+/*!
+    @brief  Copy the log out oldest record first, which unwraps a ring.
+    @param  dst
+            Destination buffer.
+    @param  size
+            Size of dst; at most this many bytes are copied.
+    @return Bytes copied.
+*/
+size_t Adafruit_SH110X_RecordingTransport::readLog(uint8_t *dst,
+                                                   size_t size) const {
+  size_t n = min(size, _log_len);
+  for (size_t i = 0; i < n; i++) {
+    dst[i] = _log[(_start + i) % _log_size];
+  }
+  return n;
+}
+
+/*!
+    @brief  Feed a log back into a transport, reproducing the original
+            sessions and writes, e.g. into an Adafruit_SH110X_Emulator or
+            Adafruit_SH110X_TimingModel.
+    @param  log
+            Log from readLog(), a stream capture or a file.
+    @param  len
+            Log length in bytes.
+    @param  to
+            Transport to replay into.
+    @return true if the whole log was replayed, false if it is truncated
+            or a write failed.
+    @note   A write that was split into several records is passed on as
+            one, using a temporary buffer; if that cannot be allocated the
+            pieces are passed on separately.
+*/
+bool Adafruit_SH110X_RecordingTransport::replay(const uint8_t *log,
+                                                size_t len,
+                                                Adafruit_SH110X_Transport *to) {
+  size_t pos = 0;
+  while (pos < len) {
+    uint8_t kind = log[pos] & SH110X_REC_KIND;
+    if (kind == SH110X_REC_BEGIN) {
+      to->beginSession();
+      pos++;
+      continue;
+    }
+    if (kind == SH110X_REC_END) {
+      to->endSession();
+      pos++;
+      continue;
+    }
+
+    // find the records making up this write
+    size_t start = pos, total = 0, records = 0;
+    uint8_t n;
+    do {
+      if (pos >= len) {
+        return false;
+      }
+      n = log[pos] & SH110X_REC_MAX_LEN;
+      if (pos + 1 + n > len) {
+        return false;
+      }
+      total += n;
+      records++;
+      pos += 1 + n;
+    } while (n == SH110X_REC_MAX_LEN);
+
+    uint8_t *joined = (records > 1) ? (uint8_t *)malloc(total) : NULL;
+    bool ok = true;
+    if (joined) {
+      size_t j = 0;
+      for (size_t p = start; p < pos; p += 1 + (log[p] & SH110X_REC_MAX_LEN)) {
+        memcpy(joined + j, log + p + 1, log[p] & SH110X_REC_MAX_LEN);
+        j += log[p] & SH110X_REC_MAX_LEN;
+      }
+      ok = (kind == SH110X_REC_DATA) ? to->writeData(joined, total)
+                                     : to->writeCommands(joined, total);
+      free(joined);
+    } else {
+      for (size_t p = start; ok && (p < pos);
+           p += 1 + (log[p] & SH110X_REC_MAX_LEN)) {
+        uint8_t rn = log[p] & SH110X_REC_MAX_LEN;
+        if (rn || (records == 1)) {
+          ok = (kind == SH110X_REC_DATA) ? to->writeData(log + p + 1, rn)
+                                         : to->writeCommands(log + p + 1, rn);
+        }
+      }
+    }
+    if (!ok) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*!
+    @brief  Append one write to the log and sink, split into records of at
+            most SH110X_REC_MAX_LEN payload bytes. The log keeps whole
+            writes only, so replay() never starts part way into one.
+    @param  kind
+            One of the SH110X_REC_ kinds.
+    @param  buf
+            Payload, may be NULL when len is 0.
+    @param  len
+            Payload length.
+*/
+void Adafruit_SH110X_RecordingTransport::_record(uint8_t kind,
+                                                 const uint8_t *buf,
+                                                 size_t len) {
+  // a record of SH110X_REC_MAX_LEN is always followed by another one
+  bool store = _reserve(len + len / SH110X_REC_MAX_LEN + 1);
+  uint8_t n;
+  do {
+    n = min(len, (size_t)SH110X_REC_MAX_LEN);
+    _append(kind | n, buf, n, store);
+    buf += n;
+    len -= n;
+  } while (n == SH110X_REC_MAX_LEN);
+}
+
+/*!
+    @brief  Make room in the log for one whole write, dropping the oldest
+            writes in ring mode.
+    @param  need
+            Bytes the write takes in the log, headers included.
+    @return true if the write fits and should be stored.
+*/
+bool Adafruit_SH110X_RecordingTransport::_reserve(size_t need) {
+  if (!_log || (_overflow && !_ring)) {
+    // a linear log keeps an unbroken prefix, so stop at the first miss
+    return false;
+  }
+  if (need > _log_size) {
+    // a ring restarts after the write it could not hold, so it still
+    // holds the newest traffic without a gap; a linear log keeps its
+    // prefix
+    _overflow = true;
+    if (_ring) {
+      _log_len = _start = 0;
+    }
+    return false;
+  }
+  if (_log_len + need <= _log_size) {
+    return true;
+  }
+  _overflow = true;
+  if (!_ring) {
+    return false;
+  }
+  while (_log_len + need > _log_size) {
+    // drop a whole write: its full records, then the short one ending it
+    uint8_t n;
+    do {
+      n = _log[_start] & SH110X_REC_MAX_LEN;
+      _start = (_start + 1 + n) % _log_size;
+      _log_len -= 1 + n;
+    } while (n == SH110X_REC_MAX_LEN);
+  }
+  return true;
+}
+
+/*!
+    @brief  Send one record to the sink and, if room was reserved for it,
+            store it in the log.
+    @param  header
+            Record header byte.
+    @param  buf
+            Payload.
+    @param  n
+            Payload length.
+    @param  store
+            Whether to store it in the log.
+*/
+void Adafruit_SH110X_RecordingTransport::_append(uint8_t header,
+                                                 const uint8_t *buf, uint8_t n,
+                                                 bool store) {
+  if (_sink) {
+    _sink->write(header);
+    if (n) {
+      _sink->write(buf, n);
+    }
+  }
+  if (!store) {
+    return;
+  }
+
+  size_t end = _start + _log_len;
+  _log[end++ % _log_size] = header;
+  for (uint8_t i = 0; i < n; i++) {
+    _log[end++ % _log_size] = buf[i];
+  }
+  _log_len += 1 + n;
+}
@@ -0,0 +1,187 @@
+/*!
+ * @file Adafruit_SH110X_Transport.h
+ *
+ * Bus transports for SH110X displays. The display only ever sends command
+ * batches and data streams, optionally grouped into a session (one frame),
+ * so I2C, SPI, test doubles or DMA engines can be swapped in without
+ * touching the flush code.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#ifndef _Adafruit_SH110X_Transport_H_
+#define _Adafruit_SH110X_Transport_H_
+
+#include "Adafruit_SH110X_Trace.h"
+#include <Adafruit_I2CDevice.h>
+#include <Adafruit_SPIDevice.h>
+#include <Arduino.h>
+
+/*!
+    @brief  Abstract byte pipe to an SH110X controller.
+*/
+class Adafruit_SH110X_Transport {
+public:
+  virtual ~Adafruit_SH110X_Transport(void) {}
+
+  /*!
+    @brief  Prepare the bus, called from the display's begin().
+    @return true on success.
+  */
+  virtual bool begin(void) { return true; }
+
+  /*!
+    @brief  Start a group of writes that belong together (one frame).
+            Writes are also allowed outside a session.
+  */
+  virtual void beginSession(void) {}
+
+  /*!
+    @brief  End a group of writes started with beginSession().
+  */
+  virtual void endSession(void) {}
+
+  /*!
+    @brief  Send bytes to be interpreted as commands.
+    @param  cmds
+            Command (and command argument) bytes.
+    @param  len
+            Number of bytes.
+    @return true on success, false on a bus error.
+  */
+  virtual bool writeCommands(const uint8_t *cmds, size_t len) = 0;
+
+  /*!
+    @brief  Send bytes to be written into display RAM.
+    @param  data
+            Display data bytes.
+    @param  len
+            Number of bytes.
+    @return true on success, false on a bus error.
+  */
+  virtual bool writeData(const uint8_t *data, size_t len) = 0;
+};
+
+/*!
+    @brief  I2C transport: each write is prefixed with the SH110X control
+            byte (0x00 commands, 0x40 data) and split to fit the device's
+            buffer. Writes run at the faster 'during' clock, switched once
+            per session, or around each write made outside a session.
+*/
+class Adafruit_SH110X_I2CTransport : public Adafruit_SH110X_Transport {
+public:
+  Adafruit_SH110X_I2CTransport(Adafruit_I2CDevice *dev, uint32_t clkDuring,
+                               uint32_t clkAfter);
+
+  bool begin(void);
+  void beginSession(void);
+  void endSession(void);
+  bool writeCommands(const uint8_t *cmds, size_t len);
+  bool writeData(const uint8_t *data, size_t len);
+
+private:
+  bool _write(uint8_t control, const uint8_t *buf, size_t len);
+
+  Adafruit_I2CDevice *_dev;
+  uint32_t _clk_during, _clk_after;
+  bool _in_session = false; ///< Bus already at the 'during' clock
+};
+
+/*!
+    @brief  SPI transport, for both native hardware SPI and bitbang SPI
+            (the Adafruit_SPIDevice handles either). The D/C pin selects
+            commands (low) or data (high).
+*/
+class Adafruit_SH110X_SPITransport : public Adafruit_SH110X_Transport {
+public:
+  Adafruit_SH110X_SPITransport(Adafruit_SPIDevice *dev, int16_t dc_pin);
+
+  bool begin(void);
+  bool writeCommands(const uint8_t *cmds, size_t len);
+  bool writeData(const uint8_t *data, size_t len);
+
+private:
+  Adafruit_SPIDevice *_dev;
+  int16_t _dc_pin;
+};
+
+#define SH110X_REC_COMMANDS 0x00 ///< Record: command bytes follow
+#define SH110X_REC_DATA 0x40     ///< Record: display data bytes follow
+#define SH110X_REC_BEGIN 0x80    ///< Record: session begin, no payload
+#define SH110X_REC_END 0xC0      ///< Record: session end, no payload
+#define SH110X_REC_KIND 0xC0     ///< Mask of the record kind in a header
+#define SH110X_REC_MAX_LEN 0x3F  ///< Longest payload in a single record
+
+/*!
+    @brief  Test double and capture tool that counts and logs everything
+            sent to it, and can optionally pass it on to another transport
+            (a 'tap').
+
+            The log is a sequence of records: one header byte (kind in the
+            top two bits, payload length in the low six) then the payload.
+            Writes longer than SH110X_REC_MAX_LEN bytes are split, and a
+            record of exactly SH110X_REC_MAX_LEN bytes is always continued
+            by the next one (possibly empty), so write boundaries survive.
+
+            The log can be a linear buffer that stops when full, a ring
+            that keeps the newest whole writes, and/or a Print stream (Serial,
+            an SD card file...) that receives every record as it happens.
+*/
+class Adafruit_SH110X_RecordingTransport : public Adafruit_SH110X_Transport {
+public:
+  Adafruit_SH110X_RecordingTransport(
+      Adafruit_SH110X_Transport *downstream = NULL, uint8_t *log = NULL,
+      size_t log_size = 0, bool ring = false);
+
+  bool begin(void);
+  void beginSession(void);
+  void endSession(void);
+  bool writeCommands(const uint8_t *cmds, size_t len);
+  bool writeData(const uint8_t *data, size_t len);
+
+  void reset(void);
+  size_t readLog(uint8_t *dst, size_t size) const;
+  static bool replay(const uint8_t *log, size_t len,
+                     Adafruit_SH110X_Transport *to);
+
+  /*!
+    @brief  Also stream every record to a Print, e.g. an open file.
+    @param  sink
+            Stream to write records to, or NULL to stop streaming.
+  */
+  void setSink(Print *sink) { _sink = sink; }
+
+  /*!
+    @brief  Bytes of the log used so far.
+    @return Length of the valid part of the log buffer.
+  */
+  size_t logLength(void) const { return _log_len; }
+
+  /*!
+    @brief  Whether records were lost for lack of space: dropped at the end
+            of a linear log, or overwritten at the start of a ring.
+    @return true if the log is incomplete.
+  */
+  bool overflowed(void) const { return _overflow; }
+
+  uint32_t commandBytes; ///< Command bytes seen since reset()
+  uint32_t dataBytes;    ///< Data bytes seen since reset()
+  uint32_t writes;       ///< writeCommands() plus writeData() calls
+  uint32_t sessions;     ///< beginSession() calls
+
+private:
+  void _record(uint8_t kind, const uint8_t *buf, size_t len);
+  bool _reserve(size_t need);
+  void _append(uint8_t header, const uint8_t *buf, uint8_t n, bool store);
+
+  Adafruit_SH110X_Transport *_downstream;
+  uint8_t *_log;
+  size_t _log_size, _log_len = 0;
+  size_t _start = 0; ///< Oldest record in ring mode
+  bool _ring;
+  bool _overflow = false;
+  Print *_sink = NULL;
+};
+
+#endif // _Adafruit_SH110X_Transport_H_
@@ -0,0 +1,311 @@
+/*********************************************************************
+  Bus traffic benchmark for SH110X displays
+
+  Runs the draw routines from the SH1107_128x128 and QT Py SH1106
+  examples against a recording transport and a chain of timing models
+  instead of a real display, and prints for each one the bytes that
+  would go over the wire, how many I2C transactions that takes, and the
+  raw transfer time at common I2C and SPI clocks. No display needs to be
+  attached.
+
+  Run it before and after changing the flush code to see what the
+  change costs or saves. The host build in extras/host runs it and
+  fails if a routine sends more than extras/host/bus_budget.txt allows.
+
+  BSD license, check license.txt for more information
+  All text above must be included in any redistribution
+*********************************************************************/
+
+#include <Adafruit_GFX.h>
+#include <Adafruit_SH110X.h>
+#include <Adafruit_SH110X_Timing.h>
+
+// Every write passes through all of these, wire time only
+Adafruit_SH110X_TimingModel spi20M(SH110X_BUS_SPI, 20000000);
+Adafruit_SH110X_TimingModel spi8M(SH110X_BUS_SPI, 8000000, &SH110X_MCU_IDEAL,
+                                  &spi20M);
+Adafruit_SH110X_TimingModel i2c1M(SH110X_BUS_I2C, 1000000, &SH110X_MCU_IDEAL,
+                                  &spi8M);
+Adafruit_SH110X_TimingModel i2c400k(SH110X_BUS_I2C, 400000,
+                                    &SH110X_MCU_IDEAL, &i2c1M);
+Adafruit_SH110X_TimingModel i2c100k(SH110X_BUS_I2C, 100000,
+                                    &SH110X_MCU_IDEAL, &i2c400k);
+// Counts bytes and frames, keeps no log
+Adafruit_SH110X_RecordingTransport meter(&i2c100k);
+
+Adafruit_SH110X *display;
+
+// Prototypes, so the sketch also builds as plain C++ (see extras/host)
+void runAll(const __FlashStringHelper *panel, bool begun);
+void bench(const __FlashStringHelper *name, void (*routine)(void));
+void printColumn(uint32_t value);
+void fullframe(void);
+void testdrawline(void);
+void testdrawrect(void);
+void testfillrect(void);
+void testdrawcircle(void);
+void testfillcircle(void);
+void testdrawroundrect(void);
+void testfillroundrect(void);
+void testdrawtriangle(void);
+void testfilltriangle(void);
+void testdrawchar(void);
+void testdrawstyles(void);
+void testdrawbitmap(void);
+void testanimate(void);
+
+static const uint8_t PROGMEM logo_bmp[] = {
+    0b00000000, 0b11000000, 0b00000001, 0b11000000, 0b00000001, 0b11000000,
+    0b00000011, 0b11100000, 0b11110011, 0b11100000, 0b11111110, 0b11111000,
+    0b01111110, 0b11111111, 0b00110011, 0b10011111, 0b00011111, 0b11111100,
+    0b00001101, 0b01110000, 0b00011011, 0b10100000, 0b00111111, 0b11100000,
+    0b00111111, 0b11110000, 0b01111100, 0b11110000, 0b01110000, 0b01110000,
+    0b00000000, 0b00110000};
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial)
+    delay(10);
+
+  Serial.println(F("SH110X bus benchmark (times in us)"));
+
+  Adafruit_SH1106G *sh1106 = new Adafruit_SH1106G(128, 64, &meter);
+  display = sh1106;
+  runAll(F("SH1106G 128x64"), sh1106->begin());
+  delete sh1106;
+
+  Adafruit_SH1107 *sh1107 = new Adafruit_SH1107(128, 128, &meter);
+  display = sh1107;
+  runAll(F("SH1107 128x128"), sh1107->begin());
+  delete sh1107;
+
+  Serial.println(F("done"));
+}
+
+void loop() {}
+
+void runAll(const __FlashStringHelper *panel, bool begun) {
+  Serial.println();
+  Serial.println(panel);
+  if (!begun) {
+    Serial.println(F("begin() failed, not enough RAM for this panel"));
+    return;
+  }
+  Serial.println(F("routine\tframes\tcmd\tdata\txfers\ti2c100k\ti2c400k"
+                   "\ti2c1M\tspi8M\tspi20M"));
+
+  bench(F("display"), fullframe);
+  bench(F("drawline"), testdrawline);
+  bench(F("drawrect"), testdrawrect);
+  bench(F("fillrect"), testfillrect);
+  bench(F("drawcircle"), testdrawcircle);
+  bench(F("fillcircle"), testfillcircle);
+  bench(F("drawroundrect"), testdrawroundrect);
+  bench(F("fillroundrect"), testfillroundrect);
+  bench(F("drawtriangle"), testdrawtriangle);
+  bench(F("filltriangle"), testfilltriangle);
+  bench(F("drawchar"), testdrawchar);
+  bench(F("drawstyles"), testdrawstyles);
+  bench(F("drawbitmap"), testdrawbitmap);
+  bench(F("animate"), testanimate);
+}
+
+void bench(const __FlashStringHelper *name, void (*routine)(void)) {
+  display->clearDisplay();
+  display->display();
+  meter.reset();
+  i2c100k.reset();
+  i2c400k.reset();
+  i2c1M.reset();
+  spi8M.reset();
+  spi20M.reset();
+
+  routine();
+
+  Serial.print(name);
+  printColumn(meter.sessions);
+  printColumn(meter.commandBytes);
+  printColumn(meter.dataBytes);
+  printColumn(i2c100k.transactions);
+  printColumn(i2c100k.totalMicros());
+  printColumn(i2c400k.totalMicros());
+  printColumn(i2c1M.totalMicros());
+  printColumn(spi8M.totalMicros());
+  printColumn(spi20M.totalMicros());
+  Serial.println();
+}
+
+void printColumn(uint32_t value) {
+  Serial.print('\t');
+  Serial.print(value);
+}
+
+// The routines below are the example sketches' draw loops, minus delays
+
+void fullframe(void) {
+  display->fillScreen(SH110X_WHITE);
+  display->display();
+}
+
+void testdrawline(void) {
+  int16_t w = display->width(), h = display->height();
+  for (int16_t i = 0; i < w; i += 4) {
+    display->drawLine(0, 0, i, h - 1, SH110X_WHITE);
+    display->display();
+  }
+  for (int16_t i = 0; i < h; i += 4) {
+    display->drawLine(0, 0, w - 1, i, SH110X_WHITE);
+    display->display();
+  }
+  display->clearDisplay();
+  for (int16_t i = 0; i < w; i += 4) {
+    display->drawLine(0, h - 1, i, 0, SH110X_WHITE);
+    display->display();
+  }
+  for (int16_t i = h - 1; i >= 0; i -= 4) {
+    display->drawLine(0, h - 1, w - 1, i, SH110X_WHITE);
+    display->display();
+  }
+  display->clearDisplay();
+  for (int16_t i = w - 1; i >= 0; i -= 4) {
+    display->drawLine(w - 1, h - 1, i, 0, SH110X_WHITE);
+    display->display();
+  }
+  for (int16_t i = h - 1; i >= 0; i -= 4) {
+    display->drawLine(w - 1, h - 1, 0, i, SH110X_WHITE);
+    display->display();
+  }
+  display->clearDisplay();
+  for (int16_t i = 0; i < h; i += 4) {
+    display->drawLine(w - 1, 0, 0, i, SH110X_WHITE);
+    display->display();
+  }
+  for (int16_t i = 0; i < w; i += 4) {
+    display->drawLine(w - 1, 0, i, h - 1, SH110X_WHITE);
+    display->display();
+  }
+}
+
+void testdrawrect(void) {
+  int16_t w = display->width(), h = display->height();
+  for (int16_t i = 0; i < h / 2; i += 2) {
+    display->drawRect(i, i, w - 2 * i, h - 2 * i, SH110X_WHITE);
+    display->display();
+  }
+}
+
+void testfillrect(void) {
+  int16_t w = display->width(), h = display->height();
+  for (int16_t i = 0; i < h / 2; i += 3) {
+    display->fillRect(i, i, w - i * 2, h - i * 2, SH110X_INVERSE);
+    display->display();
+  }
+}
+
+void testdrawcircle(void) {
+  int16_t w = display->width(), h = display->height();
+  for (int16_t i = 0; i < max(w, h) / 2; i += 2) {
+    display->drawCircle(w / 2, h / 2, i, SH110X_WHITE);
+    display->display();
+  }
+}
+
+void testfillcircle(void) {
+  int16_t w = display->width(), h = display->height();
+  for (int16_t i = max(w, h) / 2; i > 0; i -= 3) {
+    display->fillCircle(w / 2, h / 2, i, SH110X_INVERSE);
+    display->display();
+  }
+}
+
+void testdrawroundrect(void) {
+  int16_t w = display->width(), h = display->height();
+  for (int16_t i = 0; i < h / 2 - 2; i += 2) {
+    display->drawRoundRect(i, i, w - 2 * i, h - 2 * i, h / 4, SH110X_WHITE);
+    display->display();
+  }
+}
+
+void testfillroundrect(void) {
+  int16_t w = display->width(), h = display->height();
+  for (int16_t i = 0; i < h / 2 - 2; i += 2) {
+    display->fillRoundRect(i, i, w - 2 * i, h - 2 * i, h / 4, SH110X_INVERSE);
+    display->display();
+  }
+}
+
+void testdrawtriangle(void) {
+  int16_t w = display->width(), h = display->height();
+  for (int16_t i = 0; i < max(w, h) / 2; i += 5) {
+    display->drawTriangle(w / 2, h / 2 - i, w / 2 - i, h / 2 + i, w / 2 + i,
+                          h / 2 + i, SH110X_WHITE);
+    display->display();
+  }
+}
+
+void testfilltriangle(void) {
+  int16_t w = display->width(), h = display->height();
+  for (int16_t i = max(w, h) / 2; i > 0; i -= 5) {
+    display->fillTriangle(w / 2, h / 2 - i, w / 2 - i, h / 2 + i, w / 2 + i,
+                          h / 2 + i, SH110X_INVERSE);
+    display->display();
+  }
+}
+
+void testdrawchar(void) {
+  display->setTextSize(1);
+  display->setTextColor(SH110X_WHITE);
+  display->setCursor(0, 0);
+  display->cp437(true);
+  for (int16_t i = 0; i < 256; i++) {
+    display->write(i == '\n' ? ' ' : i);
+  }
+  display->display();
+}
+
+void testdrawstyles(void) {
+  display->setTextSize(1);
+  display->setTextColor(SH110X_WHITE);
+  display->setCursor(0, 0);
+  display->println(F("Hello, world!"));
+  display->setTextColor(SH110X_BLACK, SH110X_WHITE);
+  display->println(3.141592);
+  display->setTextSize(2);
+  display->setTextColor(SH110X_WHITE);
+  display->print(F("0x"));
+  display->println(0xDEADBEEF, HEX);
+  display->display();
+}
+
+void testdrawbitmap(void) {
+  display->drawBitmap((display->width() - 16) / 2, (display->height() - 16) / 2,
+                      logo_bmp, 16, 16, 1);
+  display->display();
+}
+
+// 50 frames of the falling logos, from a fixed seed so runs compare
+void testanimate(void) {
+  int16_t icons[10][3];
+  randomSeed(1);
+  for (uint8_t f = 0; f < 10; f++) {
+    icons[f][0] = random(1 - 16, display->width());
+    icons[f][1] = -16;
+    icons[f][2] = random(1, 6);
+  }
+  for (uint8_t frame = 0; frame < 50; frame++) {
+    display->clearDisplay();
+    for (uint8_t f = 0; f < 10; f++) {
+      display->drawBitmap(icons[f][0], icons[f][1], logo_bmp, 16, 16,
+                          SH110X_WHITE);
+    }
+    display->display();
+    for (uint8_t f = 0; f < 10; f++) {
+      icons[f][1] += icons[f][2];
+      if (icons[f][1] >= display->height()) {
+        icons[f][0] = random(1 - 16, display->width());
+        icons[f][1] = -16;
+        icons[f][2] = random(1, 6);
+      }
+    }
+  }
+}
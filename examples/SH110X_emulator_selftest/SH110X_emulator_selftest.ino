@@ -0,0 +1,336 @@
+/*********************************************************************
+  Golden-image self test for the SH110X flush path
+
+  Renders known scenes through the real begin() and display() code into
+  an emulated SH1106/SH1107 and checks what the panel would show:
+
+  - every scene (splash, the examples' test patterns, text in all four
+    rotations, partial updates) must appear on the panel exactly as it
+    is in the framebuffer, which catches column offset, page, dirty
+    window and addressing bugs in the flush code
+  - corner markers in each rotation must land on the panel pixels worked
+    out independently here, which catches rotation and mirroring bugs
+  - a ring capture that wraps during a full frame must still replay as
+    whole writes, the newest part of the traffic
+
+  On a failure the panel and framebuffer are printed as PBM images.
+  Run it after touching display(), the transports or the init tables.
+  Needs about 5 KB of RAM for the 128x128 panel.
+
+  BSD license, check license.txt for more information
+  All text above must be included in any redistribution
+*********************************************************************/
+
+#include <Adafruit_GFX.h>
+#include <Adafruit_SH110X.h>
+#include <Adafruit_SH110X_Emulator.h>
+
+Adafruit_SH110X *display;
+Adafruit_SH110X_Emulator *emu;
+uint16_t failures, checks;
+
+// Prototypes, so the sketch also builds as plain C++ (see extras/host)
+void testPanel(sh110x_chip_t chip, uint16_t w, uint16_t h,
+               const sh110x_profile_t *profile = NULL, int16_t firstSEG = -1);
+void scenes(uint8_t rotation);
+void cornerMarkers(uint8_t rotation);
+bool panelPixel(int16_t x, int16_t y, uint8_t rotation);
+uint16_t countLit(void);
+void partialUpdates(void);
+void ringReplay(void);
+void linearPrefix(void);
+bool writeBoundary(const uint8_t *log, size_t len, size_t at);
+void check(const __FlashStringHelper *scene, int8_t rotation);
+void report(const __FlashStringHelper *scene, int8_t rotation, bool ok);
+void printBuffer(void);
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial)
+    delay(10);
+
+  Serial.println(F("SH110X emulator self test"));
+
+  testPanel(SH110X_CHIP_SH1106, 128, 64);
+  testPanel(SH110X_CHIP_SH1107, 128, 128);
+  testPanel(SH110X_CHIP_SH1107, 64, 128);
+  // clone wired from SEG0 instead of SEG2
+  testPanel(SH110X_CHIP_SH1106, 128, 64, &SH1106_PROFILE_128X64_SEG0, 0);
+
+  Serial.println();
+  Serial.print(checks);
+  Serial.print(F(" checks, "));
+  Serial.print(failures);
+  Serial.println(F(" failures"));
+  Serial.println(failures ? F("FAIL") : F("PASS"));
+}
+
+void loop() {}
+
+// firstSEG wires the emulated panel from that SEG pin, see setFirstSEG()
+void testPanel(sh110x_chip_t chip, uint16_t w, uint16_t h,
+               const sh110x_profile_t *profile, int16_t firstSEG) {
+  Serial.println();
+  Serial.print(chip == SH110X_CHIP_SH1106 ? F("SH1106G ") : F("SH1107 "));
+  Serial.print(w);
+  Serial.print('x');
+  Serial.print(h);
+  if (firstSEG >= 0) {
+    Serial.print(F(", wired from SEG"));
+    Serial.print(firstSEG);
+  }
+  Serial.println();
+
+  emu = new Adafruit_SH110X_Emulator(chip, w, h);
+  if (firstSEG >= 0) {
+    emu->setFirstSEG(firstSEG);
+  }
+  bool begun;
+  if (chip == SH110X_CHIP_SH1106) {
+    Adafruit_SH1106G *d = new Adafruit_SH1106G(w, h, emu);
+    display = d;
+    d->setProfile(profile);
+    begun = d->begin();
+  } else {
+    Adafruit_SH1107 *d = new Adafruit_SH1107(w, h, emu);
+    display = d;
+    d->setProfile(profile);
+    begun = d->begin();
+  }
+
+  if (begun) {
+    display->display();
+    check(F("splash"), -1);
+
+    for (uint8_t r = 0; r < 4; r++) {
+      display->setRotation(r);
+      scenes(r);
+    }
+    display->setRotation(0);
+    partialUpdates();
+    ringReplay();
+    linearPrefix();
+  } else {
+    Serial.println(F("  begin() failed, not enough RAM"));
+  }
+
+  delete display;
+  delete emu;
+}
+
+void scenes(uint8_t rotation) {
+  int16_t w = display->width(), h = display->height();
+
+  display->clearDisplay();
+  display->display();
+  check(F("clear"), rotation);
+
+  for (int16_t i = 0; i < max(w, h); i += 8) {
+    display->drawLine(0, 0, i, h - 1, SH110X_WHITE);
+    display->drawLine(w - 1, 0, 0, i, SH110X_WHITE);
+  }
+  display->display();
+  check(F("lines"), rotation);
+
+  display->clearDisplay();
+  for (int16_t i = 0; i < h / 2; i += 3) {
+    display->fillRect(i, i, w - i * 2, h - i * 2, SH110X_INVERSE);
+  }
+  display->display();
+  check(F("rects"), rotation);
+
+  display->clearDisplay();
+  for (int16_t i = max(w, h) / 2; i > 0; i -= 5) {
+    display->fillCircle(w / 2, h / 2, i, SH110X_INVERSE);
+  }
+  display->display();
+  check(F("circles"), rotation);
+
+  display->clearDisplay();
+  display->setTextSize(1);
+  display->setTextColor(SH110X_WHITE);
+  display->setCursor(0, 0);
+  display->cp437(true);
+  for (int16_t i = 32; i < 256; i++) {
+    display->write(i);
+  }
+  display->display();
+  check(F("text"), rotation);
+
+  display->clearDisplay();
+  display->setTextSize(2);
+  display->setTextColor(SH110X_BLACK, SH110X_WHITE);
+  display->setCursor(3, 5);
+  display->print(F("Rot "));
+  display->print(rotation);
+  display->display();
+  check(F("inverse text"), rotation);
+
+  cornerMarkers(rotation);
+}
+
+// A 3x2 block at the logical top left and a dot at the bottom right must
+// show up where the rotation maps them on the unrotated panel
+void cornerMarkers(uint8_t rotation) {
+  int16_t w = display->width(), h = display->height();
+  display->clearDisplay();
+  display->fillRect(1, 1, 3, 2, SH110X_WHITE);
+  display->drawPixel(w - 1, h - 1, SH110X_WHITE);
+  display->display();
+
+  uint16_t lit = 0;
+  bool ok = true;
+  for (int16_t y = 0; y < h; y++) {
+    for (int16_t x = 0; x < w; x++) {
+      bool want = ((x >= 1) && (x <= 3) && (y >= 1) && (y <= 2)) ||
+                  ((x == w - 1) && (y == h - 1));
+      if (want && !panelPixel(x, y, rotation)) {
+        ok = false;
+      }
+      lit += want;
+    }
+  }
+  ok = ok && (countLit() == lit);
+  report(F("corners"), rotation, ok);
+}
+
+// Panel pixel at a rotated (logical) coordinate, same mapping as GFX
+bool panelPixel(int16_t x, int16_t y, uint8_t rotation) {
+  int16_t nw = emu->width(), nh = emu->height();
+  switch (rotation) {
+  case 1:
+    return emu->getPixel(nw - 1 - y, x);
+  case 2:
+    return emu->getPixel(nw - 1 - x, nh - 1 - y);
+  case 3:
+    return emu->getPixel(y, nh - 1 - x);
+  }
+  return emu->getPixel(x, y);
+}
+
+uint16_t countLit(void) {
+  uint16_t n = 0;
+  for (uint16_t y = 0; y < emu->height(); y++) {
+    for (uint16_t x = 0; x < emu->width(); x++) {
+      n += emu->getPixel(x, y);
+    }
+  }
+  return n;
+}
+
+// Small updates after a full frame only push the dirty window
+void partialUpdates(void) {
+  display->clearDisplay();
+  display->fillScreen(SH110X_WHITE);
+  display->display();
+  for (uint8_t i = 0; i < 20; i++) {
+    display->drawPixel((i * 37) % display->width(),
+                       (i * 23) % display->height(), SH110X_BLACK);
+    display->fillRect(i * 5, i * 3, 7, 9, SH110X_INVERSE);
+    display->display();
+  }
+  check(F("partial updates"), -1);
+}
+
+// A full frame through a small ring: what is left must replay as whole
+// writes and match the end of a linear capture of the same frame
+void ringReplay(void) {
+  const size_t full_size = 4096, ring_size = 256;
+  uint8_t *full = (uint8_t *)malloc(full_size);
+  uint8_t *ring = (uint8_t *)malloc(ring_size);
+  uint8_t *kept = (uint8_t *)malloc(ring_size);
+  uint8_t *replayed = (uint8_t *)malloc(ring_size);
+  if (!full || !ring || !kept || !replayed) {
+    Serial.println(F("  ring replay skipped, not enough RAM"));
+  } else {
+    Adafruit_SH110X_RecordingTransport linear(emu, full, full_size);
+    Adafruit_SH110X_RecordingTransport tail(&linear, ring, ring_size, true);
+    display->setTransport(&tail);
+    display->fillScreen(SH110X_WHITE);
+    display->display();
+    display->setTransport(emu);
+
+    size_t n = tail.readLog(kept, ring_size);
+    Adafruit_SH110X_RecordingTransport out(NULL, replayed, ring_size);
+    size_t len = linear.logLength();
+    bool ok = tail.overflowed() && !linear.overflowed() &&
+              Adafruit_SH110X_RecordingTransport::replay(kept, n, &out) &&
+              (out.logLength() == n) && (n <= len) &&
+              !memcmp(replayed, full + len - n, n) &&
+              writeBoundary(full, len, len - n);
+    report(F("ring replay"), -1, ok);
+  }
+  free(full);
+  free(ring);
+  free(kept);
+  free(replayed);
+}
+
+// A write too big for a linear log must leave what was captured before it
+void linearPrefix(void) {
+  const size_t size = 64;
+  uint8_t log[size], before[size], after[size];
+  uint8_t big[size + 8];
+  memset(big, 0xA5, sizeof(big));
+
+  Adafruit_SH110X_RecordingTransport rec(NULL, log, size);
+  const uint8_t cmds[] = {0xB0, 0x10, 0x02};
+  rec.writeCommands(cmds, sizeof(cmds));
+  rec.writeData(big, 10);
+  size_t n = rec.readLog(before, size);
+  rec.writeData(big, sizeof(big));
+  rec.writeCommands(cmds, sizeof(cmds)); // dropped too: no gaps
+  bool ok = n && rec.overflowed() && (rec.logLength() == n) &&
+            (rec.readLog(after, size) == n) && !memcmp(before, after, n);
+  report(F("linear log prefix"), -1, ok);
+}
+
+// Whether a write (or session record) starts at this offset of a log
+bool writeBoundary(const uint8_t *log, size_t len, size_t at) {
+  size_t pos = 0;
+  bool continued = false;
+  while (pos < at) {
+    uint8_t n = log[pos] & SH110X_REC_MAX_LEN;
+    continued = !(log[pos] & 0x80) && (n == SH110X_REC_MAX_LEN);
+    pos += 1 + n;
+  }
+  return (pos == at) && (at < len) && !continued;
+}
+
+void check(const __FlashStringHelper *scene, int8_t rotation) {
+  report(scene, rotation, emu->mismatches(display->getBuffer()) == 0);
+}
+
+void report(const __FlashStringHelper *scene, int8_t rotation, bool ok) {
+  checks++;
+  if (ok) {
+    return;
+  }
+  failures++;
+  Serial.print(F("  FAIL "));
+  Serial.print(scene);
+  if (rotation >= 0) {
+    Serial.print(F(" rotation "));
+    Serial.print(rotation);
+  }
+  Serial.println();
+  Serial.println(F("panel:"));
+  emu->printPBM(&Serial);
+  Serial.println(F("framebuffer:"));
+  printBuffer();
+}
+
+void printBuffer(void) {
+  uint16_t w = emu->width(), h = emu->height();
+  const uint8_t *buf = display->getBuffer();
+  Serial.println(F("P1"));
+  Serial.print(w);
+  Serial.print(' ');
+  Serial.println(h);
+  for (uint16_t y = 0; y < h; y++) {
+    for (uint16_t x = 0; x < w; x++) {
+      Serial.print((buf[x + (y / 8) * w] >> (y & 7)) & 1 ? '1' : '0');
+    }
+    Serial.println();
+  }
+}
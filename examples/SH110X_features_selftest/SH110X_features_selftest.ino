@@ -0,0 +1,599 @@
+/*********************************************************************
+  Self test for the SH110X controller features
+
+  Drives the display's controller-side features through an emulated
+  SH1106/SH1107 and checks both what the panel would show and the bytes
+  sent to get there:
+
+  - beginAsync()/pollBegin() bring the panel up without blocking, and a
+    failed display-on write is reported as a failed begin
+  - beginGroup() brings up two panels on one reset pin with a single
+    settle time, and tells which panel failed
+  - the register shadow sends nothing for a setting the panel already
+    has, and deferCommands() folds held changes into one write
+  - sleep() keeps the image, wake() costs one byte, or pushes only what
+    was drawn while asleep, and dim() keeps the contrast for later
+  - setPixelShift() and burn-in steps move the image by whole lines,
+    blank what moves past the edge, and only send the edge strips
+  - partial display shows just the strip, display() sends just the
+    strip, and leaving it brings back everything drawn meanwhile
+  - setDisplayClock() sends the 0xD5 setting once, and setFrameRate()
+    lands close to the rate asked for
+  - displayPaced() sends at most one flush per frame slot, folding the
+    calls in between into it
+  - with SH110X_ENABLE_STATS, the statistics count every byte that
+    reached the bus, and none that did not
+
+  On a failure the panel and the framebuffer are printed as PBM images.
+  Run it after touching any of these features. Needs about 12 KB of RAM
+  for the 128x128 panel.
+
+  BSD license, check license.txt for more information
+  All text above must be included in any redistribution
+*********************************************************************/
+
+#include <Adafruit_GFX.h>
+#include <Adafruit_SH110X.h>
+#include <Adafruit_SH110X_Emulator.h>
+
+#define GROUP_RST_PIN 9 // toggled by the beginGroup() test, leave it free
+
+// Passes everything on to another transport, failing writes on request
+class FailSwitch : public Adafruit_SH110X_Transport {
+public:
+  FailSwitch(Adafruit_SH110X_Transport *to) : to(to) {}
+  bool begin(void) { return to->begin(); }
+  void beginSession(void) { to->beginSession(); }
+  void endSession(void) { to->endSession(); }
+  bool writeCommands(const uint8_t *cmds, size_t len) {
+    return !fail && to->writeCommands(cmds, len);
+  }
+  bool writeData(const uint8_t *data, size_t len) {
+    return !fail && to->writeData(data, len);
+  }
+
+  Adafruit_SH110X_Transport *to;
+  bool fail = false;
+};
+
+sh110x_chip_t chip;
+Adafruit_SH110X *display;
+Adafruit_SH110X_Emulator *emu;
+FailSwitch *bus;
+Adafruit_SH110X_RecordingTransport *meter; // display -> meter -> bus -> emu
+uint16_t failures, checks;
+
+// Prototypes, so the sketch also builds as plain C++ (see extras/host)
+void testPanel(sh110x_chip_t c, uint16_t w, uint16_t h);
+Adafruit_SH110X *newDisplay(Adafruit_SH110X_Transport *transport,
+                            int16_t rst_pin = -1);
+bool asyncBegin(void);
+void settleFailure(void);
+void groupBegin(void);
+void registerShadow(void);
+void sleepWake(void);
+void pixelShift(void);
+void checkShifted(const __FlashStringHelper *scene, int8_t lines);
+void partialDisplay(void);
+void checkStrip(const __FlashStringHelper *scene, uint8_t first,
+                uint8_t count);
+bool panelLine(uint16_t line, uint16_t i);
+bool bufferLine(uint16_t line, uint16_t i);
+void panelClock(void);
+void framePacing(void);
+void statistics(void);
+void check(const __FlashStringHelper *scene);
+void report(const __FlashStringHelper *scene, bool ok);
+void printBuffer(void);
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial)
+    delay(10);
+
+  Serial.println(F("SH110X features self test"));
+
+  testPanel(SH110X_CHIP_SH1106, 128, 64);
+  testPanel(SH110X_CHIP_SH1107, 128, 128);
+  testPanel(SH110X_CHIP_SH1107, 64, 128);
+
+  Serial.println();
+  Serial.print(checks);
+  Serial.print(F(" checks, "));
+  Serial.print(failures);
+  Serial.println(F(" failures"));
+  Serial.println(failures ? F("FAIL") : F("PASS"));
+}
+
+void loop() {}
+
+void testPanel(sh110x_chip_t c, uint16_t w, uint16_t h) {
+  Serial.println();
+  Serial.print(c == SH110X_CHIP_SH1106 ? F("SH1106G ") : F("SH1107 "));
+  Serial.print(w);
+  Serial.print('x');
+  Serial.println(h);
+
+  chip = c;
+  emu = new Adafruit_SH110X_Emulator(c, w, h);
+  bus = new FailSwitch(emu);
+  meter = new Adafruit_SH110X_RecordingTransport(bus);
+
+  settleFailure();
+  groupBegin();
+  display = newDisplay(meter);
+  if (asyncBegin()) {
+    display->display();
+    check(F("splash"));
+    registerShadow();
+    sleepWake();
+    pixelShift();
+    partialDisplay();
+    panelClock();
+    framePacing();
+    statistics();
+  } else {
+    Serial.println(F("  begin() failed, not enough RAM"));
+  }
+
+  delete display;
+  delete meter;
+  delete bus;
+  delete emu;
+}
+
+// A display of the panel under test, not begun yet
+Adafruit_SH110X *newDisplay(Adafruit_SH110X_Transport *transport,
+                            int16_t rst_pin) {
+  if (chip == SH110X_CHIP_SH1106) {
+    return new Adafruit_SH1106G(emu->width(), emu->height(), transport,
+                                rst_pin);
+  }
+  return new Adafruit_SH1107(emu->width(), emu->height(), transport, rst_pin);
+}
+
+// BRING-UP -----------------------------------------------------------------
+
+// pollBegin() returns straight away during the settle time, so it takes
+// many polls, and the display is on once it reports READY
+bool asyncBegin(void) {
+  uint32_t t0 = millis();
+  display->beginAsync();
+  uint16_t polls = 0;
+  bool asleep = false; // the panel is off until SETTLE, but not asleep
+  sh110x_begin_state_t state;
+  while (((state = display->pollBegin()) != SH110X_BEGIN_READY) &&
+         (state != SH110X_BEGIN_FAILED)) {
+    asleep = asleep || display->isSleeping();
+    polls++;
+    delay(1);
+  }
+  report(F("beginAsync"), (state == SH110X_BEGIN_READY) && emu->isOn() &&
+                              !asleep && (polls >= 100) &&
+                              (millis() - t0 >= 100));
+  return state == SH110X_BEGIN_READY;
+}
+
+// A display-on write that fails on the bus fails the whole bring-up
+void settleFailure(void) {
+  Adafruit_SH110X *d = newDisplay(meter);
+  d->beginAsync();
+  sh110x_begin_state_t state;
+  while ((state = d->pollBegin()) == SH110X_BEGIN_INIT) {
+  }
+  bus->fail = (state == SH110X_BEGIN_SETTLE);
+  while ((state = d->pollBegin()) == SH110X_BEGIN_SETTLE) {
+    delay(1);
+  }
+  report(F("begin with display-on failing"),
+         bus->fail && (state == SH110X_BEGIN_FAILED) && !emu->isOn());
+  bus->fail = false;
+  delete d;
+}
+
+// Two panels sharing a reset pin come up in about one reset and one
+// settle time, not two of each
+void groupBegin(void) {
+  Adafruit_SH110X_Emulator *emus[2];
+  FailSwitch *buses[2];
+  Adafruit_SH110X *group[2];
+  for (uint8_t i = 0; i < 2; i++) {
+    emus[i] = new Adafruit_SH110X_Emulator(chip, emu->width(), emu->height());
+    buses[i] = new FailSwitch(emus[i]);
+    group[i] = newDisplay(buses[i], GROUP_RST_PIN);
+  }
+
+  uint32_t t0 = millis();
+  bool ok = Adafruit_SH110X::beginGroup(group, NULL, 2);
+  uint32_t elapsed = millis() - t0;
+  for (uint8_t i = 0; i < 2; i++) {
+    group[i]->display();
+    ok = ok && emus[i]->isOn() &&
+         (emus[i]->mismatches(group[i]->getBuffer()) == 0);
+  }
+  report(F("beginGroup"), ok && (elapsed >= 100) && (elapsed < 200) &&
+                              (digitalRead(GROUP_RST_PIN) == HIGH));
+
+  buses[1]->fail = true;
+  ok = Adafruit_SH110X::beginGroup(group, NULL, 2);
+  report(F("beginGroup with one panel failing"),
+         !ok && (group[0]->pollBegin() == SH110X_BEGIN_READY) &&
+             (group[1]->pollBegin() == SH110X_BEGIN_FAILED));
+
+  for (uint8_t i = 0; i < 2; i++) {
+    delete group[i];
+    delete buses[i];
+    delete emus[i];
+  }
+}
+
+// REGISTER SHADOW ----------------------------------------------------------
+
+void registerShadow(void) {
+  display->setContrast(0x30);
+  meter->reset();
+  display->setContrast(0x30);
+  display->setContrast(0x30);
+  display->invertDisplay(false);
+  report(F("repeated setContrast"), meter->commandBytes == 0);
+
+  display->setContrast(0x31);
+  display->setContrast(0x31);
+  report(F("changed setContrast"), (meter->commandBytes == 2) &&
+                                       (meter->writes == 1) &&
+                                       (emu->contrast() == 0x31));
+
+  // only the last value of each register goes out, in one write
+  meter->reset();
+  display->deferCommands(true);
+  for (uint8_t i = 0; i < 5; i++) {
+    display->setContrast(0x40 + i);
+    display->invertDisplay(i & 1);
+  }
+  display->invertDisplay(false); // back to what the panel has
+  bool held = (meter->commandBytes == 0);
+  display->deferCommands(false);
+  report(F("deferCommands"), held && (meter->commandBytes == 2) &&
+                                 (meter->writes == 1) &&
+                                 (emu->contrast() == 0x44));
+
+  // held changes ride along with the next frame's session
+  meter->reset();
+  display->deferCommands(true);
+  display->setContrast(0x50);
+  display->invertDisplay(true);
+  display->display(); // nothing dirty: just the register write
+  display->deferCommands(false);
+  report(F("deferCommands with display()"),
+         (meter->commandBytes == 3) && (meter->writes == 1) &&
+             (meter->sessions == 1) && (emu->contrast() == 0x50));
+  display->invertDisplay(false);
+
+  // a raw command may change anything, so the next setter resends
+  display->oled_command(SH110X_NORMALDISPLAY);
+  meter->reset();
+  display->setContrast(0x50);
+  report(F("setContrast after oled_command"), meter->commandBytes == 2);
+  check(F("register shadow"));
+}
+
+// SLEEP, WAKE AND DIM -------------------------------------------------------
+
+void sleepWake(void) {
+  display->clearDisplay();
+  display->fillCircle(emu->width() / 2, emu->height() / 2, 20, SH110X_WHITE);
+
+  // never put to sleep: wake() has nothing to catch up on
+  meter->reset();
+  bool woke = display->wake();
+  report(F("wake while awake"), woke && !meter->dataBytes);
+  display->display();
+
+  display->sleep();
+  report(F("sleep"), !emu->isOn() && display->isSleeping());
+  meter->reset();
+  woke = display->wake();
+  report(F("wake without changes"), woke && !display->isSleeping() &&
+                                        (meter->commandBytes == 1) &&
+                                        (meter->dataBytes == 0));
+  check(F("wake without changes"));
+
+  // a 10x3 box on one page: only those ten columns go out before wake
+  display->sleep();
+  display->fillRect(2, 17, 10, 3, SH110X_INVERSE);
+  meter->reset();
+  woke = display->wake();
+  report(F("wake after drawing"), woke && (meter->dataBytes == 10));
+  check(F("wake after drawing"));
+
+  display->setContrast(0x60);
+  display->dim(true);
+  display->setContrast(0x70);
+  bool dimmed = (emu->contrast() == 0);
+  display->dim(false);
+  report(F("dim"), dimmed && (emu->contrast() == 0x70));
+}
+
+// PIXEL SHIFT --------------------------------------------------------------
+
+void pixelShift(void) {
+  uint16_t w = emu->width(), h = emu->height();
+  display->clearDisplay();
+  display->drawRect(0, 0, w, h, SH110X_WHITE);
+  display->fillTriangle(4, 4, w - 5, h / 2, 4, h - 5, SH110X_WHITE);
+  display->display();
+
+  report(F("setPixelShift 3"), display->setPixelShift(3));
+  checkShifted(F("shifted by 3"), 3);
+
+  // drawing coordinates are unchanged while shifted
+  display->fillCircle(w / 2, h / 2, 9, SH110X_INVERSE);
+  display->display();
+  checkShifted(F("drawn while shifted"), 3);
+
+  meter->reset();
+  report(F("setPixelShift -4"), display->setPixelShift(-4));
+  report(F("pixel shift sends edges only"),
+         meter->dataBytes < (uint32_t)w * h / 8 / 2);
+  checkShifted(F("shifted by -4"), -4);
+
+  display->setPixelShift(0);
+  check(F("shift undone"));
+
+  display->setBurnInProtection(2, 1000);
+  bool early = display->burnInTick();
+  delay(1000);
+  bool stepped = display->burnInTick();
+  report(F("burn-in step"), !early && stepped && display->getPixelShift());
+  checkShifted(F("burn-in step"), display->getPixelShift());
+  display->setBurnInProtection(0);
+  report(F("burn-in off"), display->getPixelShift() == 0);
+  check(F("burn-in off"));
+}
+
+// The framebuffer moved by a number of lines along the COMs (rows on
+// SH1106, columns on SH1107), with lines moved in from past the edge dark
+void checkShifted(const __FlashStringHelper *scene, int8_t lines) {
+  uint16_t w = emu->width(), h = emu->height();
+  const uint8_t *buf = display->getBuffer();
+  bool com_x = (chip == SH110X_CHIP_SH1107);
+  uint32_t bad = 0;
+  for (int16_t y = 0; y < h; y++) {
+    for (int16_t x = 0; x < w; x++) {
+      int16_t fx = com_x ? x + lines : x, fy = com_x ? y : y + lines;
+      bool want = (fx >= 0) && (fx < w) && (fy >= 0) && (fy < h) &&
+                  ((buf[fx + (fy / 8) * w] >> (fy & 7)) & 1);
+      bad += (want != emu->getPixel(x, y));
+    }
+  }
+  report(scene, bad == 0);
+  if (bad) {
+    Serial.println(F("panel:"));
+    emu->printPBM(&Serial);
+  }
+}
+
+// PARTIAL DISPLAY ----------------------------------------------------------
+
+void partialDisplay(void) {
+  uint16_t w = emu->width(), h = emu->height();
+  bool com_x = (chip == SH110X_CHIP_SH1107);
+  uint16_t across = com_x ? h : w; // pixels along each COM line
+
+  display->clearDisplay();
+  display->fillCircle(w / 2, h / 2, min(w, h) / 2 - 2, SH110X_WHITE);
+  display->display();
+
+  report(F("partial strip too small"), !display->setPartialDisplay(16, 8));
+  report(F("setPartialDisplay"), display->setPartialDisplay(16, 16) &&
+                                     display->isPartialDisplay());
+  checkStrip(F("partial display"), 16, 16);
+
+  // drawn over the whole panel, but only the strip goes out
+  for (int16_t i = 0; i < max(w, h); i += 6) {
+    display->drawLine(i, 0, 0, i, SH110X_INVERSE);
+  }
+  display->drawRect(0, 0, w, h, SH110X_INVERSE);
+  meter->reset();
+  display->display();
+  report(F("partial display() sends the strip"),
+         meter->dataBytes == 16UL * across / 8);
+  checkStrip(F("drawn in partial display"), 16, 16);
+
+  report(F("exitPartialDisplay"),
+         display->exitPartialDisplay() && !display->isPartialDisplay());
+  check(F("partial display left"));
+}
+
+// The panel must show the strip's lines, in order, on some run of
+// consecutive lines, and nothing anywhere else
+void checkStrip(const __FlashStringHelper *scene, uint8_t first,
+                uint8_t count) {
+  bool com_x = (chip == SH110X_CHIP_SH1107);
+  uint16_t lines = com_x ? emu->width() : emu->height();
+  uint16_t across = com_x ? emu->height() : emu->width();
+  bool found = false;
+  for (uint16_t at = 0; !found && (at + count <= lines); at++) {
+    found = true;
+    for (uint16_t l = 0; found && (l < lines); l++) {
+      bool in_strip = (l >= at) && (l < at + count);
+      for (uint16_t i = 0; found && (i < across); i++) {
+        bool want = in_strip && bufferLine(first + l - at, i);
+        found = (panelLine(l, i) == want);
+      }
+    }
+  }
+  report(scene, found);
+  if (!found) {
+    Serial.println(F("panel:"));
+    emu->printPBM(&Serial);
+  }
+}
+
+// Pixel i along a COM line, on the panel and in the framebuffer
+bool panelLine(uint16_t line, uint16_t i) {
+  return (chip == SH110X_CHIP_SH1107) ? emu->getPixel(line, i)
+                                      : emu->getPixel(i, line);
+}
+
+bool bufferLine(uint16_t line, uint16_t i) {
+  bool com_x = (chip == SH110X_CHIP_SH1107);
+  uint16_t x = com_x ? line : i, y = com_x ? i : line;
+  return (display->getBuffer()[x + (y / 8) * emu->width()] >> (y & 7)) & 1;
+}
+
+// PANEL CLOCK --------------------------------------------------------------
+
+void panelClock(void) {
+  report(F("setDisplayClock range"), !display->setDisplayClock(16, 1) &&
+                                         !display->setDisplayClock(5, 0) &&
+                                         !display->setDisplayClock(5, 17));
+
+  uint8_t log[8], sent[8];
+  Adafruit_SH110X_RecordingTransport rec(meter, log, sizeof(log));
+  display->setTransport(&rec);
+  display->setDisplayClock(5, 1);
+  uint32_t one = display->getFramePeriodMicros();
+  rec.reset();
+  bool ok = display->setDisplayClock(7, 2);
+  size_t n = rec.readLog(sent, sizeof(sent));
+  ok = ok && (n == 3) && (sent[0] == (SH110X_REC_COMMANDS | 2)) &&
+       (sent[1] == SH110X_SETDISPLAYCLOCKDIV) && (sent[2] == 0x71);
+  rec.reset();
+  display->setDisplayClock(7, 2);
+  report(F("setDisplayClock"), ok && (rec.logLength() == 0));
+  display->setTransport(meter);
+
+  // twice the divide at the same oscillator setting is twice the period
+  display->setDisplayClock(5, 2);
+  uint32_t two = display->getFramePeriodMicros();
+  report(F("frame period"), (two >= 2 * one - 1) && (two <= 2 * one + 1));
+
+  uint32_t period = display->setFrameRate(60);
+  report(F("setFrameRate"), (period == display->getFramePeriodMicros()) &&
+                                (period > 15000) && (period < 18333));
+}
+
+// FRAME PACING -------------------------------------------------------------
+
+void framePacing(void) {
+  display->clearDisplay();
+  display->display();
+  report(F("setPacing"), display->setPacing(50) == 20000);
+  display->resetPacingStats();
+  meter->reset();
+
+  // the first call starts a slot; the next two fall inside it
+  bool sent[3];
+  for (uint8_t i = 0; i < 3; i++) {
+    display->fillRect(i * 10, i * 5, 8, 8, SH110X_WHITE);
+    sent[i] = display->displayPaced();
+    delay(5);
+  }
+  delay(5); // next slot starts 20 ms after the first
+  bool caught_up = display->displayPaced();
+  delay(20);
+  bool idle = display->displayPaced(); // nothing drawn since
+  const sh110x_pacing_t &stats = display->getPacingStats();
+  report(F("displayPaced"), sent[0] && !sent[1] && !sent[2] && caught_up &&
+                                !idle && (stats.frames == 2) &&
+                                (stats.coalesced == 2) &&
+                                (stats.skipped == 1) &&
+                                (meter->sessions == 2));
+  check(F("displayPaced"));
+
+  uint32_t interval = display->setPacing(50, true);
+  uint32_t period = display->getFramePeriodMicros();
+  report(F("setPacing locked to the panel"),
+         interval && (interval % period == 0));
+
+  display->setPacing(0);
+  display->drawPixel(1, 1, SH110X_INVERSE);
+  report(F("unpaced displayPaced"), display->displayPaced());
+  check(F("unpaced displayPaced"));
+}
+
+// STATISTICS ---------------------------------------------------------------
+
+// Commands of every kind and data are counted where they meet the bus, so
+// the counters must agree with what the transport saw
+void statistics(void) {
+#ifdef SH110X_ENABLE_STATS
+  display->resetStats();
+  meter->reset();
+  display->setContrast(0x21);
+  display->oled_command(SH110X_NORMALDISPLAY);
+  display->fillRect(3, 5, 20, 9, SH110X_INVERSE);
+  display->display();
+  const sh110x_stats_t &s = display->getStats();
+  report(F("stats bytes"), (s.commandBytes == meter->commandBytes) &&
+                               (s.dataBytes == meter->dataBytes) &&
+                               (s.transactions == meter->writes) &&
+                               !s.busErrors);
+
+  // nothing dirty, or nothing left inside a partial strip: no frame
+  display->display();
+  display->setPartialDisplay(0, 16);
+  display->drawPixel(emu->width() - 1, emu->height() - 1, SH110X_INVERSE);
+  display->display();
+  report(F("stats frames"), s.frames == 1);
+  display->exitPartialDisplay();
+
+  // failed writes are counted as transactions and errors, not bytes
+  display->resetStats();
+  meter->reset();
+  bus->fail = true;
+  display->setContrast(0x22);
+  display->fillRect(3, 5, 20, 9, SH110X_INVERSE);
+  display->display();
+  bus->fail = false;
+  report(F("stats bus errors"), !s.commandBytes && !s.dataBytes &&
+                                    s.transactions &&
+                                    (s.busErrors == s.transactions) &&
+                                    (s.transactions == meter->writes));
+
+  display->fillRect(0, 0, emu->width(), emu->height(), SH110X_INVERSE);
+  display->fillRect(0, 0, emu->width(), emu->height(), SH110X_INVERSE);
+  display->display();
+  check(F("statistics"));
+#endif
+}
+
+// RESULTS ------------------------------------------------------------------
+
+void check(const __FlashStringHelper *scene) {
+  bool ok = emu->mismatches(display->getBuffer()) == 0;
+  report(scene, ok);
+  if (ok) {
+    return;
+  }
+  Serial.println(F("panel:"));
+  emu->printPBM(&Serial);
+  Serial.println(F("framebuffer:"));
+  printBuffer();
+}
+
+void report(const __FlashStringHelper *scene, bool ok) {
+  checks++;
+  if (ok) {
+    return;
+  }
+  failures++;
+  Serial.print(F("  FAIL "));
+  Serial.println(scene);
+}
+
+void printBuffer(void) {
+  uint16_t w = emu->width(), h = emu->height();
+  const uint8_t *buf = display->getBuffer();
+  Serial.println(F("P1"));
+  Serial.print(w);
+  Serial.print(' ');
+  Serial.println(h);
+  for (uint16_t y = 0; y < h; y++) {
+    for (uint16_t x = 0; x < w; x++) {
+      Serial.print((buf[x + (y / 8) * w] >> (y & 7)) & 1 ? '1' : '0');
+    }
+    Serial.println();
+  }
+}
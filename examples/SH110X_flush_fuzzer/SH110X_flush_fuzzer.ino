@@ -0,0 +1,235 @@
+/*********************************************************************
+  Differential fuzzer for the SH110X dirty window and partial flushes
+
+  Plays random sequences of drawing operations (in every rotation, with
+  coordinates off the edges, direct framebuffer writes plus markDirty(),
+  direct writeDisplayData() runs) and random flush strategies against
+  an emulated SH1106/SH1107. After every flush the panel image must be
+  identical to the framebuffer. It also totals how many data bytes the
+  partial flushes saved compared to sending every frame in full.
+
+  On a failure it prints the input bytes, which replay the failing
+  sequence exactly. Each input starts from a known, fully flushed state.
+
+  fuzzOne() takes its operations from a byte string, so on a desktop it
+  can also be linked with libFuzzer: build this file as C++ with
+  -DSH110X_LIBFUZZER -fsanitize=fuzzer against the host core in
+  extras/host.
+
+  BSD license, check license.txt for more information
+  All text above must be included in any redistribution
+*********************************************************************/
+
+#include <Adafruit_GFX.h>
+#include <Adafruit_SH110X.h>
+#include <Adafruit_SH110X_Emulator.h>
+
+#define INPUT_LEN 96 // bytes of random input per run
+
+// One emulated panel under test, with a counter in front of it
+struct Panel {
+  Adafruit_SH110X_Emulator *emu;
+  Adafruit_SH110X_RecordingTransport *meter;
+  Adafruit_SH110X *display;
+};
+
+Panel panels[3];
+uint8_t numPanels;
+uint32_t runs, flushes, sentBytes, fullBytes;
+uint8_t input[INPUT_LEN];
+
+// Prototypes, so the sketch also builds as plain C++ (see extras/host)
+bool addPanel(sh110x_chip_t chip, uint16_t w, uint16_t h);
+bool fuzzOne(Panel *p, const uint8_t *data, size_t len);
+bool same(Panel *p);
+
+// Pulls bytes off the input, then zeros once it runs out
+struct Input {
+  const uint8_t *data;
+  size_t len;
+  uint8_t next(void) {
+    if (!len) {
+      return 0;
+    }
+    len--;
+    return *data++;
+  }
+  // a coordinate that strays up to 16 pixels past either edge
+  int16_t coord(int16_t size) {
+    return (int16_t)((next() * (size + 32L)) >> 8) - 16;
+  }
+};
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial)
+    delay(10);
+
+  addPanel(SH110X_CHIP_SH1106, 128, 64);
+  addPanel(SH110X_CHIP_SH1107, 128, 128);
+  addPanel(SH110X_CHIP_SH1107, 64, 128);
+  Serial.print(numPanels);
+  Serial.println(F(" panels under test"));
+}
+
+void loop() {
+  if (!numPanels) {
+    return;
+  }
+  for (uint8_t i = 0; i < INPUT_LEN; i++) {
+    input[i] = random(256);
+  }
+  Panel *p = &panels[runs % numPanels];
+  if (!fuzzOne(p, input, INPUT_LEN)) {
+    Serial.print(F("FAIL on panel "));
+    Serial.print(p->emu->width());
+    Serial.print('x');
+    Serial.print(p->emu->height());
+    Serial.println(F(", input:"));
+    for (uint8_t i = 0; i < INPUT_LEN; i++) {
+      Serial.print(input[i], HEX);
+      Serial.print(' ');
+    }
+    Serial.println();
+    while (1)
+      delay(1000);
+  }
+
+  if (++runs % 1000 == 0) {
+    Serial.print(runs);
+    Serial.print(F(" runs, "));
+    Serial.print(flushes);
+    Serial.print(F(" flushes, partial flushes sent "));
+    Serial.print(100.0 * sentBytes / fullBytes, 1);
+    Serial.println(F("% of the full-frame bytes"));
+  }
+}
+
+bool addPanel(sh110x_chip_t chip, uint16_t w, uint16_t h) {
+  Panel *p = &panels[numPanels];
+  p->emu = new Adafruit_SH110X_Emulator(chip, w, h);
+  p->meter = new Adafruit_SH110X_RecordingTransport(p->emu);
+  bool begun;
+  if (chip == SH110X_CHIP_SH1106) {
+    Adafruit_SH1106G *d = new Adafruit_SH1106G(w, h, p->meter);
+    p->display = d;
+    begun = d->begin();
+  } else {
+    Adafruit_SH1107 *d = new Adafruit_SH1107(w, h, p->meter);
+    p->display = d;
+    begun = d->begin();
+  }
+  if (!begun) {
+    Serial.println(F("begin() failed, not enough RAM for all panels"));
+    delete p->display;
+    delete p->meter;
+    delete p->emu;
+    return false;
+  }
+  numPanels++;
+  return true;
+}
+
+// Run one input against a panel; false if the panel and framebuffer
+// ever disagree after a flush
+bool fuzzOne(Panel *p, const uint8_t *data, size_t len) {
+  Adafruit_SH110X *d = p->display;
+  Input in = {data, len};
+  uint16_t nw = p->emu->width(), nh = p->emu->height();
+  uint8_t *buf = d->getBuffer();
+
+  d->setRotation(0);
+  d->clearDisplay();
+  d->markDirty(0, 0, nw - 1, nh - 1);
+  d->display();
+  if (!same(p)) {
+    return false;
+  }
+
+  while (in.len) {
+    uint8_t op = in.next() % 10;
+    int16_t w = d->width(), h = d->height();
+    uint16_t color = in.next() % 3;
+
+    switch (op) {
+    case 0:
+      d->drawPixel(in.coord(w), in.coord(h), color);
+      break;
+    case 1:
+      d->fillRect(in.coord(w), in.coord(h), in.next() % 40, in.next() % 40,
+                  color);
+      break;
+    case 2:
+      d->drawLine(in.coord(w), in.coord(h), in.coord(w), in.coord(h), color);
+      break;
+    case 3:
+      d->setCursor(in.coord(w), in.coord(h));
+      d->setTextColor(color ? SH110X_WHITE : SH110X_BLACK);
+      d->setTextSize(1 + (in.next() & 1));
+      d->write(in.next());
+      break;
+    case 4:
+      d->setRotation(in.next() & 3);
+      break;
+    case 5: { // poke the framebuffer directly, then mark exactly that area
+      uint16_t x = in.next() % nw;
+      uint8_t page = in.next() % (nh / 8);
+      uint8_t n = min((uint16_t)(1 + in.next() % 16), (uint16_t)(nw - x));
+      for (uint8_t i = 0; i < n; i++) {
+        buf[page * nw + x + i] = in.next();
+      }
+      d->markDirty(x, page * 8, x + n - 1, page * 8 + 7);
+      break;
+    }
+    case 6: { // write a run straight to display RAM, mirrored in the buffer
+      uint16_t x = in.next() % nw;
+      uint8_t page = in.next() % (nh / 8);
+      uint8_t n = min((uint16_t)(1 + in.next() % 16), (uint16_t)(nw - x));
+      for (uint8_t i = 0; i < n; i++) {
+        buf[page * nw + x + i] = in.next();
+      }
+      d->writeDisplayData(page, x, buf + page * nw + x, n);
+      break;
+    }
+    case 7: // full flush
+      d->markDirty(0, 0, nw - 1, nh - 1);
+      // fall through
+    default: // partial flush of whatever is dirty
+      p->meter->reset();
+      d->display();
+      flushes++;
+      sentBytes += p->meter->dataBytes;
+      fullBytes += (uint32_t)nw * (nh / 8);
+      if (!same(p)) {
+        return false;
+      }
+    }
+  }
+
+  // anything drawn but not yet flushed must still come out right
+  d->display();
+  return same(p);
+}
+
+bool same(Panel *p) {
+  return p->emu->mismatches(p->display->getBuffer()) == 0;
+}
+
+#ifdef SH110X_LIBFUZZER
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  static bool ready = false;
+  if (!ready) {
+    ready = addPanel(SH110X_CHIP_SH1106, 128, 64) &&
+            addPanel(SH110X_CHIP_SH1107, 128, 128) &&
+            addPanel(SH110X_CHIP_SH1107, 64, 128);
+  }
+  // the first byte picks the panel
+  if (!size || !ready) {
+    return 0;
+  }
+  if (!fuzzOne(&panels[data[0] % numPanels], data + 1, size - 1)) {
+    abort();
+  }
+  return 0;
+}
+#endif
@@ -0,0 +1,66 @@
+/*********************************************************************
+  Changing numbers with Adafruit_SH110X_TextField
+
+  Shows an uptime clock and a loop counter. Each field only redraws the
+  character cells that changed since its last update, so display() only
+  sends those cells instead of whole lines of text. The number of cells
+  redrawn per frame is printed on Serial.
+
+  Written for a 128x64 SH1106 on I2C; for an SH1107 swap in
+  Adafruit_SH1107 and its size.
+
+  BSD license, check license.txt for more information
+  All text above must be included in any redistribution
+*********************************************************************/
+
+#include <Adafruit_GFX.h>
+#include <Adafruit_SH110X.h>
+#include <Adafruit_SH110X_TextField.h>
+
+#define i2c_Address 0x3C // 0x3D on most Adafruit modules
+
+Adafruit_SH1106G display(128, 64, &Wire, -1);
+
+// x, y, columns, text size; y on a multiple of 8 keeps cells in one page
+Adafruit_SH110X_TextField uptime(&display, 0, 16, 8, 2);
+Adafruit_SH110X_TextField counter(&display, 0, 48, 10);
+
+uint32_t loops;
+
+void setup() {
+  Serial.begin(115200);
+
+  delay(250); // wait for the OLED to power up
+  if (!display.begin(i2c_Address, true) || !uptime.begin() ||
+      !counter.begin()) {
+    Serial.println(F("Display or text field allocation failed"));
+    while (1)
+      delay(1000);
+  }
+
+  display.clearDisplay();
+  display.setTextSize(1);
+  display.setTextColor(SH110X_WHITE);
+  display.setCursor(0, 0);
+  display.print(F("Uptime"));
+  display.setCursor(0, 38);
+  display.print(F("Loops"));
+  counter.setTextColor(SH110X_BLACK, SH110X_WHITE);
+  display.display();
+}
+
+void loop() {
+  char text[12];
+  uint32_t s = millis() / 1000;
+
+  snprintf(text, sizeof(text), "%02u:%02u:%02u", (unsigned)(s / 3600 % 100),
+           (unsigned)(s / 60 % 60), (unsigned)(s % 60));
+  uint8_t changed = uptime.update(text);
+  snprintf(text, sizeof(text), "%lu", (unsigned long)++loops);
+  changed += counter.update(text);
+
+  display.display();
+  Serial.print(F("cells redrawn: "));
+  Serial.println(changed);
+  delay(100);
+}
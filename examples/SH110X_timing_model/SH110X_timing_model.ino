@@ -0,0 +1,107 @@
+/*********************************************************************
+  Frame time estimates for SH110X displays
+
+  Records the bus traffic of one full-screen update, then replays the
+  recording through timing models for several buses, clocks and MCUs
+  and prints the estimated frame latency and frame rate. No display
+  needs to be attached.
+
+  The MCU profiles are rough; time a real flush with micros() or a logic
+  analyzer and adjust the numbers before relying on them.
+
+  BSD license, check license.txt for more information
+  All text above must be included in any redistribution
+*********************************************************************/
+
+#include <Adafruit_GFX.h>
+#include <Adafruit_SH110X.h>
+#include <Adafruit_SH110X_Timing.h>
+
+#define LOG_SIZE 2400 // one 128x128 frame with record headers
+
+uint8_t *logbuf;
+size_t loglen;
+
+// Prototypes, so the sketch also builds as plain C++ (see extras/host)
+bool record(bool begun, Adafruit_SH110X *display,
+            Adafruit_SH110X_RecordingTransport *recorder);
+void report(const __FlashStringHelper *panel);
+void estimate(sh110x_bus_t bus, uint32_t clock,
+              const __FlashStringHelper *name,
+              const sh110x_mcu_profile_t *mcu);
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial)
+    delay(10);
+
+  logbuf = (uint8_t *)malloc(LOG_SIZE);
+  if (!logbuf) {
+    Serial.println(F("Not enough RAM for the trace buffer"));
+    return;
+  }
+
+  Adafruit_SH110X_RecordingTransport recorder(NULL, logbuf, LOG_SIZE);
+
+  Adafruit_SH1106G *sh1106 = new Adafruit_SH1106G(128, 64, &recorder);
+  if (record(sh1106->begin(), sh1106, &recorder)) {
+    report(F("SH1106G 128x64"));
+  }
+  delete sh1106;
+
+  Adafruit_SH1107 *sh1107 = new Adafruit_SH1107(128, 128, &recorder);
+  if (record(sh1107->begin(), sh1107, &recorder)) {
+    report(F("SH1107 128x128"));
+  }
+  delete sh1107;
+}
+
+void loop() {}
+
+// Capture one full-screen flush (init traffic is dropped)
+bool record(bool begun, Adafruit_SH110X *display,
+            Adafruit_SH110X_RecordingTransport *recorder) {
+  if (!begun) {
+    Serial.println(F("begin() failed, not enough RAM for this panel"));
+    return false;
+  }
+  recorder->reset();
+  display->fillScreen(SH110X_WHITE);
+  display->display();
+  loglen = recorder->logLength();
+  return !recorder->overflowed();
+}
+
+void report(const __FlashStringHelper *panel) {
+  Serial.println();
+  Serial.println(panel);
+  Serial.println(F("bus\tclock\tmcu\tus/frame\tfps"));
+
+  estimate(SH110X_BUS_I2C, 100000, F("ideal"), &SH110X_MCU_IDEAL);
+  estimate(SH110X_BUS_I2C, 400000, F("ideal"), &SH110X_MCU_IDEAL);
+  estimate(SH110X_BUS_I2C, 400000, F("avr"), &SH110X_MCU_AVR);
+  estimate(SH110X_BUS_I2C, 400000, F("samd21"), &SH110X_MCU_SAMD21);
+  estimate(SH110X_BUS_I2C, 1000000, F("rp2040"), &SH110X_MCU_RP2040);
+  estimate(SH110X_BUS_I2C, 1000000, F("esp32"), &SH110X_MCU_ESP32);
+  estimate(SH110X_BUS_SPI, 8000000, F("avr"), &SH110X_MCU_AVR);
+  estimate(SH110X_BUS_SPI, 8000000, F("samd21"), &SH110X_MCU_SAMD21);
+  estimate(SH110X_BUS_SPI, 20000000, F("rp2040"), &SH110X_MCU_RP2040);
+  estimate(SH110X_BUS_SPI, 20000000, F("esp32"), &SH110X_MCU_ESP32);
+}
+
+void estimate(sh110x_bus_t bus, uint32_t clock,
+              const __FlashStringHelper *name,
+              const sh110x_mcu_profile_t *mcu) {
+  Adafruit_SH110X_TimingModel model(bus, clock, mcu);
+  model.replay(logbuf, loglen);
+
+  Serial.print(bus == SH110X_BUS_I2C ? F("i2c") : F("spi"));
+  Serial.print('\t');
+  Serial.print(clock / 1000);
+  Serial.print(F("k\t"));
+  Serial.print(name);
+  Serial.print('\t');
+  Serial.print(model.lastFrameMicros());
+  Serial.print('\t');
+  Serial.println(model.framesPerSecond(), 1);
+}
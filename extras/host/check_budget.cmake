@@ -0,0 +1,81 @@
+# Run the bus benchmark and check its counts against the budget file.
+#
+#   cmake -DBENCHMARK=<SH110X_bus_benchmark> -DBUDGET=<bus_budget.txt>
+#         -P check_budget.cmake
+#
+# Fails if a routine sends more command bytes, data bytes or I2C
+# transactions than budgeted, or if a routine is missing from either side.
+
+cmake_minimum_required(VERSION 3.10)
+
+execute_process(COMMAND ${BENCHMARK} OUTPUT_VARIABLE out RESULT_VARIABLE rc)
+if(NOT rc EQUAL 0)
+  message(FATAL_ERROR "${BENCHMARK} exited with ${rc}")
+endif()
+
+set(fields cmd data xfers)
+
+# Benchmark output: a panel line, then one tab-separated row per routine
+string(REPLACE "\r" "" out "${out}")
+string(REPLACE "\n" ";" lines "${out}")
+set(panel "")
+set(measured "")
+foreach(line IN LISTS lines)
+  if(line MATCHES "^SH11")
+    set(panel "${line}")
+  elseif(line MATCHES "^([a-z]+)\t[0-9]+\t([0-9]+)\t([0-9]+)\t([0-9]+)\t")
+    set(name "${panel}: ${CMAKE_MATCH_1}")
+    string(MAKE_C_IDENTIFIER "${name}" key)
+    set(${key}_cmd ${CMAKE_MATCH_2})
+    set(${key}_data ${CMAKE_MATCH_3})
+    set(${key}_xfers ${CMAKE_MATCH_4})
+    list(APPEND measured "${name}")
+  endif()
+endforeach()
+if(NOT measured)
+  message(FATAL_ERROR "no results in the benchmark output:\n${out}")
+endif()
+
+file(STRINGS ${BUDGET} budget REGEX "^[^#]")
+set(failed 0)
+set(budgeted "")
+foreach(line IN LISTS budget)
+  if(NOT line MATCHES "^(.+: [a-z]+) ([0-9]+) ([0-9]+) ([0-9]+)$")
+    message(FATAL_ERROR "bad line in ${BUDGET}: ${line}")
+  endif()
+  set(name "${CMAKE_MATCH_1}")
+  set(limit_cmd ${CMAKE_MATCH_2})
+  set(limit_data ${CMAKE_MATCH_3})
+  set(limit_xfers ${CMAKE_MATCH_4})
+  list(APPEND budgeted "${name}")
+  string(MAKE_C_IDENTIFIER "${name}" key)
+  if(NOT DEFINED ${key}_cmd)
+    message(SEND_ERROR "${name}: not in the benchmark output")
+    set(failed 1)
+    continue()
+  endif()
+  foreach(f IN LISTS fields)
+    if(${key}_${f} GREATER limit_${f})
+      message(SEND_ERROR "${name}: ${f} ${${key}_${f}} is over the budget "
+                         "of ${limit_${f}}")
+      set(failed 1)
+    elseif(${key}_${f} LESS limit_${f})
+      message(STATUS
+              "${name}: ${f} ${${key}_${f}} is under the budget of "
+              "${limit_${f}}, lower it in ${BUDGET}")
+    endif()
+  endforeach()
+endforeach()
+
+foreach(name IN LISTS measured)
+  if(NOT name IN_LIST budgeted)
+    message(SEND_ERROR "${name}: no budget, add it to ${BUDGET}")
+    set(failed 1)
+  endif()
+endforeach()
+
+if(failed)
+  message(FATAL_ERROR "FAIL")
+endif()
+list(LENGTH measured count)
+message(STATUS "PASS: ${count} routines within budget")
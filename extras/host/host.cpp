@@ -0,0 +1,199 @@
+/*
+ * Host side of the Arduino core in include/Arduino.h: Serial on stdout,
+ * simulated time, pin levels, a portable random(), the BusIO write hooks
+ * and a main() that runs the sketch.
+ *
+ * Usage: <sketch> [loops]
+ *   Calls setup() once, then loop() the given number of times (default 1).
+ *
+ * A sketch that parks itself (e.g. `while (1) delay(1000);` after a
+ * failure) would never return, so delay() exits with status 2 once the
+ * simulated clock passes HOST_TIME_LIMIT_MS.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ */
+
+/// @cond HOST_SHIM
+
+#include <Adafruit_I2CDevice.h>
+#include <Adafruit_SPIDevice.h>
+#include <Arduino.h>
+
+#ifndef HOST_TIME_LIMIT_MS
+#define HOST_TIME_LIMIT_MS 3600000UL ///< One simulated hour
+#endif
+
+HardwareSerial Serial;
+TwoWire Wire;
+SPIClass SPI;
+
+void (*host_i2c_write)(uint8_t addr, const uint8_t *buffer, size_t len) = NULL;
+void (*host_spi_write)(const uint8_t *buffer, size_t len) = NULL;
+
+static uint64_t host_us = 0;
+static uint8_t host_pins[256];
+static uint32_t host_seed = 1;
+
+// Print --------------------------------------------------------------------
+
+size_t Print::write(const uint8_t *buffer, size_t size) {
+  size_t n = 0;
+  while (size--) {
+    n += write(*buffer++);
+  }
+  return n;
+}
+
+size_t Print::print(long n, int base) {
+  if ((base == DEC) && (n < 0)) {
+    return write('-') + print(0UL - (unsigned long)n, base);
+  }
+  return print((unsigned long)n, base);
+}
+
+size_t Print::print(unsigned long n, int base) {
+  char buf[8 * sizeof(long) + 1];
+  char *str = &buf[sizeof(buf) - 1];
+
+  if (base < 2) {
+    base = 10;
+  }
+  *str = '\0';
+  do {
+    char c = n % base;
+    n /= base;
+    *--str = (c < 10) ? (c + '0') : (c + 'A' - 10);
+  } while (n);
+  return write(str);
+}
+
+size_t Print::print(double n, int digits) {
+  char buf[40];
+  snprintf(buf, sizeof(buf), "%.*f", digits, n);
+  return write(buf);
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  return (fputc(c, stdout) == EOF) ? 0 : 1;
+}
+
+// Time, pins, random -------------------------------------------------------
+
+void delayMicroseconds(uint32_t us) {
+  host_us += us;
+  if (host_us / 1000 > HOST_TIME_LIMIT_MS) {
+    fflush(stdout);
+    fprintf(stderr, "host: simulated time limit reached, sketch is stuck\n");
+    exit(2);
+  }
+}
+
+void delay(uint32_t ms) { delayMicroseconds(ms * 1000UL); }
+
+uint32_t millis(void) { return (uint32_t)(host_us / 1000); }
+
+uint32_t micros(void) { return (uint32_t)host_us; }
+
+void yield(void) {}
+
+void pinMode(int16_t pin, uint8_t mode) {
+  (void)pin;
+  (void)mode;
+}
+
+void digitalWrite(int16_t pin, uint8_t value) {
+  if ((pin >= 0) && (pin < (int16_t)sizeof(host_pins))) {
+    host_pins[pin] = value ? HIGH : LOW;
+  }
+}
+
+int digitalRead(int16_t pin) {
+  if ((pin >= 0) && (pin < (int16_t)sizeof(host_pins))) {
+    return host_pins[pin];
+  }
+  return LOW;
+}
+
+void randomSeed(unsigned long seed) {
+  if (seed) {
+    host_seed = (uint32_t)seed;
+  }
+}
+
+long random(long howbig) {
+  if (howbig <= 0) {
+    return 0;
+  }
+  // xorshift32: the same sequence on every host, unlike rand()
+  host_seed ^= host_seed << 13;
+  host_seed ^= host_seed >> 17;
+  host_seed ^= host_seed << 5;
+  return (long)(host_seed % (uint32_t)howbig);
+}
+
+long random(long howsmall, long howbig) {
+  if (howsmall >= howbig) {
+    return howsmall;
+  }
+  return random(howbig - howsmall) + howsmall;
+}
+
+// BusIO --------------------------------------------------------------------
+
+bool Adafruit_I2CDevice::write(const uint8_t *buffer, size_t len, bool stop,
+                               const uint8_t *prefix_buffer,
+                               size_t prefix_len) {
+  (void)stop;
+  uint8_t t[64];
+  if ((len + prefix_len > maxBufferSize()) || (len + prefix_len > sizeof(t))) {
+    return false;
+  }
+  if (prefix_len) {
+    memcpy(t, prefix_buffer, prefix_len);
+  }
+  memcpy(t + prefix_len, buffer, len);
+  if (host_i2c_write) {
+    host_i2c_write(_addr, t, len + prefix_len);
+  }
+  return true;
+}
+
+bool Adafruit_I2CDevice::read(uint8_t *buffer, size_t len, bool stop) {
+  (void)stop;
+  memset(buffer, 0, len);
+  return true;
+}
+
+bool Adafruit_SPIDevice::write(const uint8_t *buffer, size_t len,
+                               const uint8_t *prefix_buffer,
+                               size_t prefix_len) {
+  if (host_spi_write) {
+    if (prefix_len) {
+      host_spi_write(prefix_buffer, prefix_len);
+    }
+    host_spi_write(buffer, len);
+  }
+  return true;
+}
+
+// Sketch -------------------------------------------------------------------
+
+#ifndef SH110X_LIBFUZZER // libFuzzer brings its own main()
+
+void setup(void);
+void loop(void);
+
+int main(int argc, char **argv) {
+  long loops = (argc > 1) ? atol(argv[1]) : 1;
+
+  setup();
+  while (loops-- > 0) {
+    loop();
+  }
+  fflush(stdout);
+  return 0;
+}
+
+#endif
+
+/// @endcond
@@ -0,0 +1,76 @@
+/*
+ * Host stand-in for Adafruit_GrayOLED, see Arduino.h. Monochrome (1 bpp)
+ * only, which is all the SH110X driver uses. Implemented in
+ * extras/host/gfx.cpp.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ */
+
+/// @cond HOST_SHIM
+
+#ifndef _HOST_ADAFRUIT_GRAYOLED_H_
+#define _HOST_ADAFRUIT_GRAYOLED_H_
+
+#include <Adafruit_GFX.h>
+#include <Adafruit_I2CDevice.h>
+#include <Adafruit_SPIDevice.h>
+
+#define GRAYOLED_SETCONTRAST 0x81
+#define GRAYOLED_NORMALDISPLAY 0xA6
+#define GRAYOLED_INVERTDISPLAY 0xA7
+
+#define MONOOLED_BLACK 0
+#define MONOOLED_WHITE 1
+#define MONOOLED_INVERSE 2
+
+class Adafruit_GrayOLED : public Adafruit_GFX {
+public:
+  Adafruit_GrayOLED(uint8_t bpp, uint16_t w, uint16_t h, TwoWire *twi = &Wire,
+                    int16_t rst_pin = -1, uint32_t preclk = 400000,
+                    uint32_t postclk = 100000);
+  Adafruit_GrayOLED(uint8_t bpp, uint16_t w, uint16_t h, int16_t mosi_pin,
+                    int16_t sclk_pin, int16_t dc_pin, int16_t rst_pin,
+                    int16_t cs_pin);
+  Adafruit_GrayOLED(uint8_t bpp, uint16_t w, uint16_t h, SPIClass *spi,
+                    int16_t dc_pin, int16_t rst_pin, int16_t cs_pin,
+                    uint32_t bitrate = 8000000UL);
+  ~Adafruit_GrayOLED(void);
+
+  virtual void display(void) = 0;
+  void clearDisplay(void);
+  void invertDisplay(bool i);
+  void setContrast(uint8_t contrastlevel);
+  void drawPixel(int16_t x, int16_t y, uint16_t color);
+  bool getPixel(int16_t x, int16_t y);
+  uint8_t *getBuffer(void);
+
+  void oled_command(uint8_t c);
+  bool oled_commandList(const uint8_t *c, uint8_t n);
+
+protected:
+  bool _init(uint8_t i2caddr = 0x3C, bool reset = true);
+
+  Adafruit_SPIDevice *spi_dev = NULL;
+  Adafruit_I2CDevice *i2c_dev = NULL;
+  int32_t i2c_preclk = 400000;
+  int32_t i2c_postclk = 100000;
+  uint8_t *buffer = NULL;
+
+  int16_t window_x1;
+  int16_t window_y1;
+  int16_t window_x2;
+  int16_t window_y2;
+
+  int dcPin;
+  int csPin;
+  int rstPin;
+
+  uint8_t _bpp = 1;
+
+private:
+  TwoWire *_theWire = NULL;
+};
+
+#endif // _HOST_ADAFRUIT_GRAYOLED_H_
+
+/// @endcond
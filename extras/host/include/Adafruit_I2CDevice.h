@@ -0,0 +1,46 @@
+/*
+ * Host stand-in for the BusIO I2C device, see Arduino.h. Writes go to
+ * host_i2c_write when it is set, so a test can feed them to an emulator.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ */
+
+/// @cond HOST_SHIM
+
+#ifndef _HOST_ADAFRUIT_I2CDEVICE_H_
+#define _HOST_ADAFRUIT_I2CDEVICE_H_
+
+#include <Wire.h>
+
+/*
+ * Called with each I2C write transaction, prefix included; NULL drops them.
+ */
+extern void (*host_i2c_write)(uint8_t addr, const uint8_t *buffer,
+                              size_t len);
+
+class Adafruit_I2CDevice {
+public:
+  Adafruit_I2CDevice(uint8_t addr, TwoWire *theWire = &Wire)
+      : _addr(addr), _wire(theWire) {}
+  bool begin(bool addr_detect = true) {
+    (void)addr_detect;
+    return true;
+  }
+  uint8_t address(void) { return _addr; }
+  bool write(const uint8_t *buffer, size_t len, bool stop = true,
+             const uint8_t *prefix_buffer = NULL, size_t prefix_len = 0);
+  bool read(uint8_t *buffer, size_t len, bool stop = true);
+  size_t maxBufferSize(void) { return 32; }
+  bool setSpeed(uint32_t desiredclk) {
+    _wire->setClock(desiredclk);
+    return true;
+  }
+
+private:
+  uint8_t _addr;
+  TwoWire *_wire;
+};
+
+#endif // _HOST_ADAFRUIT_I2CDEVICE_H_
+
+/// @endcond
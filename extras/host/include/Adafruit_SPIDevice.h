@@ -0,0 +1,51 @@
+/*
+ * Host stand-in for the BusIO SPI device, see Arduino.h. Writes go to
+ * host_spi_write when it is set; the D/C level is digitalRead() of the
+ * display's D/C pin.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ */
+
+/// @cond HOST_SHIM
+
+#ifndef _HOST_ADAFRUIT_SPIDEVICE_H_
+#define _HOST_ADAFRUIT_SPIDEVICE_H_
+
+#include <SPI.h>
+
+typedef enum _BitOrder {
+  SPI_BITORDER_MSBFIRST,
+  SPI_BITORDER_LSBFIRST,
+} BusIOBitOrder;
+
+/*
+ * Called with the bytes of each SPI write; NULL drops them.
+ */
+extern void (*host_spi_write)(const uint8_t *buffer, size_t len);
+
+class Adafruit_SPIDevice {
+public:
+  Adafruit_SPIDevice(int8_t cspin, uint32_t freq = 1000000,
+                     BusIOBitOrder dataOrder = SPI_BITORDER_MSBFIRST,
+                     uint8_t dataMode = SPI_MODE0, SPIClass *theSPI = &SPI) {
+    (void)cspin, (void)freq, (void)dataOrder, (void)dataMode, (void)theSPI;
+  }
+  Adafruit_SPIDevice(int8_t cspin, int8_t sck, int8_t miso, int8_t mosi,
+                     uint32_t freq = 1000000,
+                     BusIOBitOrder dataOrder = SPI_BITORDER_MSBFIRST,
+                     uint8_t dataMode = SPI_MODE0) {
+    (void)cspin, (void)sck, (void)miso, (void)mosi;
+    (void)freq, (void)dataOrder, (void)dataMode;
+  }
+  bool begin(void) { return true; }
+  bool write(const uint8_t *buffer, size_t len,
+             const uint8_t *prefix_buffer = NULL, size_t prefix_len = 0);
+  void beginTransaction(void) {}
+  void endTransaction(void) {}
+  void beginTransactionWithAssertingCS(void) {}
+  void endTransactionWithDeassertingCS(void) {}
+};
+
+#endif // _HOST_ADAFRUIT_SPIDEVICE_H_
+
+/// @endcond
@@ -0,0 +1,28 @@
+/*
+ * Host stand-in for the Arduino SPI library, see Arduino.h.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ */
+
+/// @cond HOST_SHIM
+
+#ifndef _HOST_SPI_H_
+#define _HOST_SPI_H_
+
+#include <Arduino.h>
+
+#define SPI_MODE0 0
+
+/*
+ * SPI bus; traffic goes through Adafruit_SPIDevice.
+ */
+class SPIClass {
+public:
+  void begin(void) {}
+};
+
+extern SPIClass SPI;
+
+#endif // _HOST_SPI_H_
+
+/// @endcond
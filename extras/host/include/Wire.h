@@ -0,0 +1,29 @@
+/*
+ * Host stand-in for the Arduino Wire library, see Arduino.h.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ */
+
+/// @cond HOST_SHIM
+
+#ifndef _HOST_WIRE_H_
+#define _HOST_WIRE_H_
+
+#include <Arduino.h>
+
+/*
+ * I2C bus; traffic goes through Adafruit_I2CDevice, so this only keeps the
+ * clock the library last asked for.
+ */
+class TwoWire {
+public:
+  void begin(void) {}
+  void setClock(uint32_t hz) { clock = hz; }
+  uint32_t clock = 100000;
+};
+
+extern TwoWire Wire;
+
+#endif // _HOST_WIRE_H_
+
+/// @endcond
@@ -0,0 +1,34 @@
+/*
+ * Host stand-in for the Adafruit GFX font structures. Custom fonts are not
+ * drawn by the host build; only the types are needed.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ */
+
+/// @cond HOST_SHIM
+
+#ifndef _HOST_GFXFONT_H_
+#define _HOST_GFXFONT_H_
+
+#include <stdint.h>
+
+typedef struct {
+  uint16_t bitmapOffset;
+  uint8_t width;
+  uint8_t height;
+  uint8_t xAdvance;
+  int8_t xOffset;
+  int8_t yOffset;
+} GFXglyph;
+
+typedef struct {
+  uint8_t *bitmap;
+  GFXglyph *glyph;
+  uint16_t first;
+  uint16_t last;
+  uint8_t yAdvance;
+} GFXfont;
+
+#endif // _HOST_GFXFONT_H_
+
+/// @endcond
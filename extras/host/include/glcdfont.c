@@ -0,0 +1,44 @@
+/*
+ * Host stand-in for the Adafruit GFX 5x7 font. Every glyph is a distinct
+ * but meaningless pattern: the host tests compare the driver against the
+ * same GFX code, so the shapes do not matter, only that characters differ.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ */
+
+/// @cond HOST_SHIM
+
+#ifndef FONT5X7_H
+#define FONT5X7_H
+
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+
+// clang-format off
+#define HOST_GLYPH(c)                                                          \
+  (unsigned char)((c) * 7 + 1), (unsigned char)((c) * 13 + 3),                 \
+  (unsigned char)((c) * 29 + 5), (unsigned char)((c) * 31 + 7),                \
+  (unsigned char)((c) * 37 + 9)
+#define HOST_GLYPHS16(b)                                                       \
+  HOST_GLYPH(b), HOST_GLYPH(b + 1), HOST_GLYPH(b + 2), HOST_GLYPH(b + 3),      \
+  HOST_GLYPH(b + 4), HOST_GLYPH(b + 5), HOST_GLYPH(b + 6), HOST_GLYPH(b + 7),  \
+  HOST_GLYPH(b + 8), HOST_GLYPH(b + 9), HOST_GLYPH(b + 10),                    \
+  HOST_GLYPH(b + 11), HOST_GLYPH(b + 12), HOST_GLYPH(b + 13),                  \
+  HOST_GLYPH(b + 14), HOST_GLYPH(b + 15)
+
+static const unsigned char font[] PROGMEM = {
+  HOST_GLYPHS16(0),   HOST_GLYPHS16(16),  HOST_GLYPHS16(32),
+  HOST_GLYPHS16(48),  HOST_GLYPHS16(64),  HOST_GLYPHS16(80),
+  HOST_GLYPHS16(96),  HOST_GLYPHS16(112), HOST_GLYPHS16(128),
+  HOST_GLYPHS16(144), HOST_GLYPHS16(160), HOST_GLYPHS16(176),
+  HOST_GLYPHS16(192), HOST_GLYPHS16(208), HOST_GLYPHS16(224),
+  HOST_GLYPHS16(240)};
+// clang-format on
+
+#undef HOST_GLYPH
+#undef HOST_GLYPHS16
+
+#endif // FONT5X7_H
+
+/// @endcond